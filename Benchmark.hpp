@@ -0,0 +1,603 @@
+#ifndef FIBHEAP_BENCHMARK_HPP
+#define FIBHEAP_BENCHMARK_HPP
+
+#include "PerfCounters.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * keeps the compiler from optimizing away computation of @value
+ */
+template <typename T> inline void doNotOptimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Data or unified cache of the CPU
+ */
+struct CacheLevel {
+  // e.g. "L1d", "L2", "L3"
+  std::string name;
+  size_t bytes;
+};
+
+/**
+ * reads caches of cpu0 from Linux sysfs (/sys/devices/system/cpu/cpu0/cache)
+ * @return data and unified caches from the smallest level, empty if sysfs is
+ * not available
+ */
+inline std::vector<CacheLevel> cacheLevels() {
+  std::vector<std::pair<unsigned, CacheLevel>> levels;
+  for (unsigned index = 0;; ++index) {
+    const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" +
+                            std::to_string(index) + "/";
+    std::ifstream levelFile(dir + "level"), typeFile(dir + "type"),
+        sizeFile(dir + "size");
+    unsigned level = 0;
+    std::string type, size;
+    if (!(levelFile >> level) || !(typeFile >> type) || !(sizeFile >> size))
+      break;
+    if (type == "Instruction" || size.empty())
+      continue;
+    size_t bytes = std::stoull(size);
+    switch (size.back()) {
+    case 'K':
+      bytes <<= 10;
+      break;
+    case 'M':
+      bytes <<= 20;
+      break;
+    case 'G':
+      bytes <<= 30;
+      break;
+    }
+    std::string name = "L" + std::to_string(level) + (type == "Data" ? "d" : "");
+    levels.push_back({level, CacheLevel{name, bytes}});
+  }
+  std::sort(levels.begin(), levels.end(),
+            [](const auto &first, const auto &second) {
+              return first.first < second.first;
+            });
+  std::vector<CacheLevel> result;
+  for (auto &level : levels)
+    result.push_back(std::move(level.second));
+  return result;
+}
+
+/**
+ *
+ * @return name of the smallest cache holding @bytes, "DRAM" if none does
+ */
+inline std::string memoryLevel(size_t bytes,
+                               const std::vector<CacheLevel> &caches) {
+  for (const CacheLevel &cache : caches) {
+    if (bytes <= cache.bytes)
+      return cache.name;
+  }
+  return "DRAM";
+}
+
+/**
+ * Statistics of one benchmark instance (one combination of parameters)
+ * times are in seconds per repetition
+ */
+struct BenchmarkResult {
+  BenchmarkResult(const std::string &benchmark,
+                  std::vector<std::pair<std::string, std::string>> parameters)
+      : name(benchmark), params(std::move(parameters)), samples(), median(0),
+        mean(0), stddev(0), min(0), max(0), items(0), counters(), labels(),
+        error() {}
+
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> params;
+  std::vector<double> samples;
+  double median;
+  double mean;
+  double stddev;
+  double min;
+  double max;
+  // items processed by one repetition, 0 if not set
+  double items;
+  std::vector<std::pair<std::string, double>> counters;
+  std::vector<std::pair<std::string, std::string>> labels;
+  // message of the exception thrown by the benchmark, empty on success
+  std::string error;
+
+  /**
+   *
+   * @return parameters formatted as "name=value/name=value"
+   */
+  std::string paramString() const {
+    std::string result;
+    for (const auto &param : params)
+      result += (result.empty() ? "" : "/") + param.first + "=" + param.second;
+    return result;
+  }
+};
+
+/**
+ * Context of one benchmark instance passed to the benchmark body
+ * the body prepares its data, then calls measure with the timed code
+ */
+class BenchmarkRun {
+public:
+  /**
+   * @param perf counters read around every timed repetition, may be nullptr
+   */
+  BenchmarkRun(const std::string &name,
+               std::vector<std::pair<std::string, std::string>> params,
+               unsigned warmup, unsigned repetitions,
+               PerfCounters *perf = nullptr)
+      : m_result(name, std::move(params)), m_warmup(warmup),
+        m_repetitions(repetitions), m_perf(perf) {}
+
+  BenchmarkRun(const BenchmarkRun &) = delete;
+  BenchmarkRun &operator=(const BenchmarkRun &) = delete;
+
+  /**
+   *
+   * @return name of the instance, "name/param=value/..."
+   */
+  std::string id() const {
+    std::string params = m_result.paramString();
+    return params.empty() ? m_result.name : m_result.name + "/" + params;
+  }
+
+  /**
+   * may throw exceptions (for unknown parameter)
+   * @return value of parameter @name
+   */
+  const std::string &param(const std::string &name) const {
+    for (const auto &param : m_result.params) {
+      if (param.first == name)
+        return param.second;
+    }
+    throw std::invalid_argument("Unknown benchmark parameter " + name + "!");
+  }
+
+  /**
+   * may throw exceptions (for unknown or non-numeric parameter)
+   * @return value of parameter @name as a number
+   */
+  unsigned long long number(const std::string &name) const {
+    return std::stoull(param(name));
+  }
+
+  /**
+   *
+   * @return number of untimed runs before the repetitions
+   */
+  unsigned warmup() const { return m_warmup; }
+
+  /**
+   * runs @body warmup + repetitions times, the repetitions are timed
+   * @param body timed code
+   */
+  template <typename F> void measure(F &&body) {
+    measure([] {}, std::forward<F>(body));
+  }
+
+  /**
+   * runs @setup (not timed) and @body before every warmup run and repetition
+   * @param setup code restoring the state used by @body
+   * @param body timed code
+   */
+  template <typename S, typename F> void measure(S &&setup, F &&body) {
+    for (unsigned i = 0; i < m_warmup; ++i) {
+      setup();
+      body();
+    }
+    if (m_perf)
+      m_perf->clear();
+    for (unsigned i = 0; i < m_repetitions; ++i) {
+      setup();
+      if (m_perf)
+        m_perf->start();
+      auto start = std::chrono::steady_clock::now();
+      body();
+      auto end = std::chrono::steady_clock::now();
+      if (m_perf)
+        m_perf->stop();
+      m_result.samples.push_back(
+          std::chrono::duration<double>(end - start).count());
+    }
+  }
+
+  /**
+   * sets number of items processed by one repetition (for throughput)
+   */
+  void setItems(double items) { m_result.items = items; }
+
+  /**
+   * adds custom value to the result (e.g. number of decreases)
+   */
+  void counter(const std::string &name, double value) {
+    m_result.counters.emplace_back(name, value);
+  }
+
+  /**
+   * adds custom text to the result (e.g. memory level of the working set)
+   */
+  void label(const std::string &name, const std::string &value) {
+    m_result.labels.emplace_back(name, value);
+  }
+
+  /**
+   * computes statistics of the measured samples
+   * @return result of the benchmark instance
+   */
+  BenchmarkResult finish() {
+    std::vector<double> sorted = m_result.samples;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t count = sorted.size();
+    BenchmarkResult &r = m_result;
+    r.median = r.mean = r.stddev = r.min = r.max = 0;
+    if (count > 0) {
+      r.median = count % 2 ? sorted[count / 2]
+                           : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+      for (double sample : sorted)
+        r.mean += sample;
+      r.mean /= count;
+      for (double sample : sorted)
+        r.stddev += (sample - r.mean) * (sample - r.mean);
+      r.stddev = count > 1 ? std::sqrt(r.stddev / (count - 1)) : 0;
+      r.min = sorted.front();
+      r.max = sorted.back();
+    }
+    if (m_perf && count > 0)
+      addPerfCounters();
+    return m_result;
+  }
+
+private:
+  /**
+   * adds hardware counters per item ("cycles/item"), or per repetition
+   * ("cycles/rep") if the number of items is not set
+   */
+  void addPerfCounters() {
+    const bool perItem = m_result.items > 0;
+    const double operations =
+        m_result.samples.size() * (perItem ? m_result.items : 1);
+    double cycles = 0, instructions = 0;
+    for (const auto &total : m_perf->totals()) {
+      counter(total.first + (perItem ? "/item" : "/rep"),
+              total.second / operations);
+      if (total.first == "cycles")
+        cycles = total.second;
+      if (total.first == "instructions")
+        instructions = total.second;
+    }
+    if (cycles > 0 && instructions > 0)
+      counter("ipc", instructions / cycles);
+  }
+
+  BenchmarkResult m_result;
+  unsigned m_warmup;
+  unsigned m_repetitions;
+  PerfCounters *m_perf;
+};
+
+/**
+ * Named benchmarks with parameter sweeps and a command line runner
+ * every benchmark runs once for every combination of its parameter values
+ */
+class BenchmarkSuite {
+public:
+  using Body = std::function<void(BenchmarkRun &)>;
+  using Sweep = std::vector<std::pair<std::string, std::vector<std::string>>>;
+
+  BenchmarkSuite() : m_benchmarks() {}
+
+  /**
+   * registers benchmark
+   * @param name name of the benchmark, e.g. "fill_empty/int"
+   * @param sweep parameters and their values, a parameter without values
+   * has to be given by --set, otherwise the benchmark has no instances
+   * @param body function measuring one combination of parameters
+   */
+  void add(const std::string &name, Sweep sweep, Body body) {
+    m_benchmarks.push_back(Benchmark{name, std::move(sweep), std::move(body)});
+  }
+
+  /**
+   * parses command line and runs selected benchmarks
+   * --filter REGEX      runs instances whose "name/params" matches REGEX
+   * --set NAME=V1,V2    replaces values of parameter NAME in every sweep
+   * --repetitions N     timed repetitions (default 5)
+   * --warmup N          untimed runs before the repetitions (default 1)
+   * --format FORMAT     text, json or csv (default text)
+   * --output FILE       writes results to FILE instead of standard output
+   * --list             prints instances without running them
+   * --perf             reports hardware performance counters per item
+   * a failing instance is reported with its error (and the repetitions
+   * measured before it failed) and the other instances still run
+   * @return exit code of the program, 1 if any instance failed
+   */
+  int main(int argc, char **argv) {
+    try {
+      Options options = parse(argc, argv);
+      std::unique_ptr<PerfCounters> perf;
+      if (options.perf && !options.list) {
+        perf = std::make_unique<PerfCounters>();
+        if (!perf->available()) {
+          std::cerr << "Performance counters are not available "
+                       "(check /proc/sys/kernel/perf_event_paranoid)"
+                    << std::endl;
+          perf.reset();
+        }
+      }
+      std::vector<BenchmarkResult> results;
+      bool failed = false;
+      for (const Benchmark &benchmark : m_benchmarks) {
+        for (auto &params : combinations(benchmark.sweep, options.overrides)) {
+          BenchmarkRun run(benchmark.name, params, options.warmup,
+                           options.repetitions, perf.get());
+          std::string id = run.id();
+          if (!std::regex_search(id, options.filter))
+            continue;
+          if (options.list) {
+            std::cout << id << std::endl;
+            continue;
+          }
+          std::cerr << "running " << id << std::endl;
+          try {
+            benchmark.body(run);
+            results.push_back(run.finish());
+          } catch (const std::exception &e) {
+            std::cerr << id << " failed: " << e.what() << std::endl;
+            results.push_back(run.finish());
+            results.back().error = e.what();
+            failed = true;
+          }
+        }
+      }
+      if (options.list)
+        return 0;
+
+      std::ofstream file;
+      if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file.is_open())
+          throw std::runtime_error("Cannot open file " + options.output + "!");
+      }
+      std::ostream &out = options.output.empty() ? std::cout : file;
+      if (options.format == "json")
+        writeJson(out, results);
+      else if (options.format == "csv")
+        writeCsv(out, results);
+      else
+        writeText(out, results);
+      return failed ? 1 : 0;
+    } catch (const std::exception &e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+private:
+  struct Benchmark {
+    std::string name;
+    Sweep sweep;
+    Body body;
+  };
+
+  struct Options {
+    std::regex filter;
+    Sweep overrides;
+    unsigned repetitions;
+    unsigned warmup;
+    std::string format;
+    std::string output;
+    bool list;
+    bool perf;
+  };
+
+  static Options parse(int argc, char **argv) {
+    Options options{std::regex(""), {}, 5, 1, "text", "", false, false};
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc)
+          throw std::invalid_argument("Missing value of " + arg + "!");
+        return argv[++i];
+      };
+      if (arg == "--filter") {
+        options.filter = std::regex(value());
+      } else if (arg == "--set") {
+        std::string set = value();
+        size_t equals = set.find('=');
+        if (equals == std::string::npos)
+          throw std::invalid_argument("Expected NAME=VALUES in --set!");
+        std::vector<std::string> values;
+        std::stringstream stream(set.substr(equals + 1));
+        for (std::string item; std::getline(stream, item, ',');)
+          values.push_back(item);
+        options.overrides.emplace_back(set.substr(0, equals), values);
+      } else if (arg == "--repetitions") {
+        options.repetitions = static_cast<unsigned>(std::stoul(value()));
+      } else if (arg == "--warmup") {
+        options.warmup = static_cast<unsigned>(std::stoul(value()));
+      } else if (arg == "--format") {
+        options.format = value();
+        if (options.format != "text" && options.format != "json" &&
+            options.format != "csv")
+          throw std::invalid_argument("Unknown format " + options.format + "!");
+      } else if (arg == "--output") {
+        options.output = value();
+      } else if (arg == "--list") {
+        options.list = true;
+      } else if (arg == "--perf") {
+        options.perf = true;
+      } else {
+        throw std::invalid_argument("Unknown option " + arg + "!");
+      }
+    }
+    return options;
+  }
+
+  /**
+   *
+   * @return all combinations of parameter values, the last parameter changes
+   * fastest
+   */
+  static std::vector<std::vector<std::pair<std::string, std::string>>>
+  combinations(Sweep sweep, const Sweep &overrides) {
+    for (auto &param : sweep) {
+      for (const auto &override : overrides) {
+        if (override.first == param.first)
+          param.second = override.second;
+      }
+    }
+    std::vector<std::vector<std::pair<std::string, std::string>>> result(1);
+    for (const auto &param : sweep) {
+      std::vector<std::vector<std::pair<std::string, std::string>>> next;
+      for (const auto &prefix : result) {
+        for (const std::string &value : param.second) {
+          next.push_back(prefix);
+          next.back().emplace_back(param.first, value);
+        }
+      }
+      result = std::move(next);
+    }
+    return result;
+  }
+
+  static std::string escapeJson(const std::string &text) {
+    std::string result;
+    for (char c : text) {
+      if (c == '"' || c == '\\') {
+        result += '\\';
+        result += c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        char code[8];
+        std::snprintf(code, sizeof(code), "\\u%04x", c);
+        result += code;
+      } else {
+        result += c;
+      }
+    }
+    return result;
+  }
+
+  static std::string escapeCsv(const std::string &text) {
+    if (text.find_first_of(",\"\n") == std::string::npos)
+      return text;
+    std::string result = "\"";
+    for (char c : text)
+      result += c == '"' ? std::string("\"\"") : std::string(1, c);
+    return result + "\"";
+  }
+
+  static void writeText(std::ostream &out,
+                        const std::vector<BenchmarkResult> &results) {
+    std::vector<std::string> ids;
+    size_t width = 10;
+    for (const BenchmarkResult &r : results) {
+      std::string params = r.paramString();
+      ids.push_back(params.empty() ? r.name : r.name + "/" + params);
+      width = std::max(width, ids.back().size() + 2);
+    }
+
+    out << std::left << std::setw(static_cast<int>(width)) << "benchmark"
+        << std::right << std::setw(14) << "median [s]" << std::setw(14)
+        << "stddev [s]" << std::setw(14) << "min [s]" << std::setw(14)
+        << "items/s" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+      const BenchmarkResult &r = results[i];
+      out << std::left << std::setw(static_cast<int>(width)) << ids[i]
+          << std::right << std::setw(14) << r.median << std::setw(14)
+          << r.stddev << std::setw(14) << r.min << std::setw(14)
+          << (r.items > 0 && r.median > 0 ? r.items / r.median : 0);
+      for (const auto &counter : r.counters)
+        out << "  " << counter.first << "=" << counter.second;
+      for (const auto &label : r.labels)
+        out << "  " << label.first << "=" << label.second;
+      if (!r.error.empty())
+        out << "  error=" << r.error;
+      out << std::endl;
+    }
+  }
+
+  static void writeJson(std::ostream &out,
+                        const std::vector<BenchmarkResult> &results) {
+    out << std::setprecision(9);
+    out << "{\n  \"context\": {\"compiler\": \"" << escapeJson(__VERSION__)
+        << "\", \"hardware_concurrency\": "
+        << std::thread::hardware_concurrency() << ", \"caches\": {";
+    const std::vector<CacheLevel> caches = cacheLevels();
+    for (size_t i = 0; i < caches.size(); ++i) {
+      out << (i ? ", " : "") << "\"" << escapeJson(caches[i].name)
+          << "\": " << caches[i].bytes;
+    }
+    out << "}},\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+      const BenchmarkResult &r = results[i];
+      out << (i ? "," : "") << "\n    {\"name\": \"" << escapeJson(r.name)
+          << "\", \"params\": {";
+      for (size_t p = 0; p < r.params.size(); ++p) {
+        out << (p ? ", " : "") << "\"" << escapeJson(r.params[p].first)
+            << "\": \"" << escapeJson(r.params[p].second) << "\"";
+      }
+      out << "}, \"repetitions\": " << r.samples.size()
+          << ", \"median\": " << r.median << ", \"mean\": " << r.mean
+          << ", \"stddev\": " << r.stddev << ", \"min\": " << r.min
+          << ", \"max\": " << r.max << ", \"items\": " << r.items
+          << ", \"counters\": {";
+      for (size_t c = 0; c < r.counters.size(); ++c) {
+        out << (c ? ", " : "") << "\"" << escapeJson(r.counters[c].first)
+            << "\": " << r.counters[c].second;
+      }
+      out << "}, \"labels\": {";
+      for (size_t l = 0; l < r.labels.size(); ++l) {
+        out << (l ? ", " : "") << "\"" << escapeJson(r.labels[l].first)
+            << "\": \"" << escapeJson(r.labels[l].second) << "\"";
+      }
+      out << "}, \"error\": \"" << escapeJson(r.error) << "\"}";
+    }
+    out << "\n  ]\n}" << std::endl;
+  }
+
+  static void writeCsv(std::ostream &out,
+                       const std::vector<BenchmarkResult> &results) {
+    out << std::setprecision(9);
+    out << "name,params,repetitions,median,mean,stddev,min,max,items,counters,"
+           "labels,error"
+        << std::endl;
+    for (const BenchmarkResult &r : results) {
+      std::string counters;
+      for (const auto &counter : r.counters) {
+        std::ostringstream value;
+        value << std::setprecision(9) << counter.second;
+        counters += (counters.empty() ? "" : ";") + counter.first + "=" +
+                    value.str();
+      }
+      std::string labels;
+      for (const auto &label : r.labels)
+        labels += (labels.empty() ? "" : ";") + label.first + "=" + label.second;
+      out << escapeCsv(r.name) << "," << escapeCsv(r.paramString()) << ","
+          << r.samples.size() << "," << r.median << "," << r.mean << ","
+          << r.stddev << "," << r.min << "," << r.max << "," << r.items << ","
+          << escapeCsv(counters) << "," << escapeCsv(labels) << ","
+          << escapeCsv(r.error) << std::endl;
+    }
+  }
+
+  std::vector<Benchmark> m_benchmarks;
+};
+
+#endif // FIBHEAP_BENCHMARK_HPP
@@ -4,7 +4,87 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <exception>
 #include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * FIBHEAP_STATS enables counting of heap operations (see FibHeap::stats),
+ * without it the counting statements are compiled out
+ */
+#ifdef FIBHEAP_STATS
+#define FIBHEAP_COUNT(statement) statement
+#else
+#define FIBHEAP_COUNT(statement)
+#endif
+
+/**
+ * FIBHEAP_VALIDATE makes FibHeap check its invariants (see FibHeap::validate)
+ * after every modification, which makes every operation linear
+ */
+#ifdef FIBHEAP_VALIDATE
+#define FIBHEAP_CHECK() validate()
+#else
+#define FIBHEAP_CHECK()
+#endif
+
+/**
+ * Counters of operations and structure of a Fibonacci heap
+ * 		links - trees linked in consolidate
+ * 		cuts - all cuts (including cascading ones)
+ * 		cascadingCuts - cuts made by cascadingCutBranch
+ * 		comparisons - calls of the compare function
+ * 		peakRoots - longest root list (m_number)
+ * 		maxDegree - highest degree of a Node
+ * 		allocations, deallocations - Nodes created and deleted
+ */
+struct FibHeapStats {
+  FibHeapStats()
+      : links(0), cuts(0), cascadingCuts(0), comparisons(0), peakRoots(0),
+        maxDegree(0), allocations(0), deallocations(0) {}
+
+  size_t links;
+  size_t cuts;
+  size_t cascadingCuts;
+  size_t comparisons;
+  size_t peakRoots;
+  unsigned maxDegree;
+  size_t allocations;
+  size_t deallocations;
+};
+
+/**
+ * Memory held by a Fibonacci heap in bytes
+ * 		nodes - Nodes including the values (sizeof each)
+ * 		payload - memory owned by the values (reported by a user function)
+ * 		allocatorSlack - estimated malloc overhead of the Node allocations
+ * 		scratch - tables allocated by a consolidate of the current heap
+ */
+struct FibHeapMemory {
+  FibHeapMemory() : nodes(0), payload(0), allocatorSlack(0), scratch(0) {}
+
+  size_t total() const { return nodes + payload + allocatorSlack + scratch; }
+
+  /**
+   * estimate of memory taken by a malloc of @bytes (glibc: 8 byte header,
+   * 16 byte alignment, at least 32 bytes)
+   * @param bytes requested size
+   * @return size of the allocated chunk
+   */
+  static size_t chunk(size_t bytes) {
+    return std::max<size_t>(32, (bytes + 8 + 15) / 16 * 16);
+  }
+
+  size_t nodes;
+  size_t payload;
+  size_t allocatorSlack;
+  size_t scratch;
+};
+
 /**
  * default function for compare makes maximal Fibonacci Heap
  */
@@ -82,6 +162,9 @@ public:
    * every handler has
    * 		m_node - pointer to a Node
    * 		m_exists - indicates if stored Node exists
+   * Handlers and their heap can be destroyed in any order, the heap
+   * invalidates Handlers of the Nodes it deletes and a Handler detaches
+   * itself from its Node
    */
   class Handler {
     Node *m_node;
@@ -91,18 +174,27 @@ public:
     Handler(const Handler &) = delete;
     Handler &operator=(const Handler &) = delete;
 
-    Handler(Node *node) : m_node(node), m_exists(true) {}
+    Handler(Node *node) : m_node(node), m_exists(true) {
+      m_node->m_handler = this;
+    }
 
   public:
+    // only existing Nodes are touched, Nodes of invalid Handlers are deleted
     Handler(Handler &&h) noexcept : m_node(h.m_node), m_exists(h.m_exists) {
-      m_node->m_handler = this;
+      if (m_exists)
+        m_node->m_handler = this;
       h.m_node = nullptr;
       h.m_exists = false;
     }
     Handler &operator=(Handler &&h) noexcept {
+      if (this == &h)
+        return *this;
+      if (m_exists)
+        m_node->m_handler = nullptr;
       m_node = h.m_node;
       m_exists = h.m_exists;
-      m_node->m_handler = this;
+      if (m_exists)
+        m_node->m_handler = this;
       h.m_node = nullptr;
       h.m_exists = false;
       return *this;
@@ -116,7 +208,11 @@ public:
      */
     const Value &value() const { return m_node->m_key; }
 
-    ~Handler() = default;
+    // the Node must not point to a destroyed Handler
+    ~Handler() {
+      if (m_exists)
+        m_node->m_handler = nullptr;
+    }
 
     friend class FibHeap;
   };
@@ -125,21 +221,24 @@ public:
    * creates empty Fibonacci heap
    * @return empty Fibonacci heap
    */
-  FibHeap() : m_top(nullptr), m_number(0), m_size(0) {}
+  FibHeap()
+      : m_top(nullptr), m_number(0), m_size(0), m_parallelRoots(0),
+        m_consolidateThreads(1) {}
 
   /**
    * copy constructs Fibonacci heap (deep copy)
    * @param other heap to copy from
    * @return copied heap
    */
-  FibHeap(const FibHeap &other) : m_top(nullptr) {
+  FibHeap(const FibHeap &other)
+      : m_top(nullptr), m_number(other.m_number), m_size(other.m_size),
+        m_parallelRoots(other.m_parallelRoots),
+        m_consolidateThreads(other.m_consolidateThreads) {
     if (other.m_top) {
       m_top = new Node(other.top());
+      FIBHEAP_COUNT(m_stats.allocations++);
       copyRec(*other.m_top, *m_top, other.m_top, m_top);
     }
-
-    m_number = other.m_number;
-    m_size = other.m_size;
   }
 
   /**
@@ -147,7 +246,9 @@ public:
    * @param other heap to move from
    * @return moved heap
    */
-  FibHeap(FibHeap &&other) noexcept : m_top(nullptr), m_number(0), m_size(0) {
+  FibHeap(FibHeap &&other) noexcept
+      : m_top(nullptr), m_number(0), m_size(0), m_parallelRoots(0),
+        m_consolidateThreads(1) {
     *this = std::move(other);
   }
 
@@ -179,6 +280,9 @@ public:
 
     m_size = other.m_size;
     other.m_size = 0;
+
+    m_parallelRoots = other.m_parallelRoots;
+    m_consolidateThreads = other.m_consolidateThreads;
     return *this;
   }
 
@@ -195,18 +299,80 @@ public:
    * @return constructed heap
    */
   template <typename It>
-  FibHeap(It begin, It end) : m_top(nullptr), m_number(0), m_size(0) {
+  FibHeap(It begin, It end)
+      : m_top(nullptr), m_number(0), m_size(0), m_parallelRoots(0),
+        m_consolidateThreads(1) {
     for (It i = begin; i != end; i++)
       insert(*i);
   }
 
+  /**
+   * constructs Fibonacci heap from range using several threads
+   * every thread builds its own sub-heap from a part of the range
+   * (allocates the Nodes and finds its top), sub-heaps are then united
+   * may throw exceptions (rethrows the first one thrown by any thread)
+   * @param begin begin of the range
+   * @param end end of the range
+   * @param threads number of threads, 0 means hardware concurrency
+   * @return constructed heap
+   */
+  template <typename It>
+  FibHeap(It begin, It end, unsigned threads)
+      : m_top(nullptr), m_number(0), m_size(0), m_parallelRoots(0),
+        m_consolidateThreads(1) {
+    const size_t count = static_cast<size_t>(std::distance(begin, end));
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    if (count < threads)
+      threads = static_cast<unsigned>(std::max<size_t>(count, 1));
+
+    if (threads == 1) {
+      for (It i = begin; i != end; i++)
+        insert(*i);
+      return;
+    }
+
+    const size_t chunk = (count + threads - 1) / threads;
+    std::vector<FibHeap> parts(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+
+    It first = begin;
+    for (unsigned t = 0; t < threads; ++t) {
+      size_t length = std::min(chunk, count - std::min(count, t * chunk));
+      workers.emplace_back([&parts, &errors, t, first, length]() {
+        try {
+          It i = first;
+          for (size_t j = 0; j < length; ++j, ++i)
+            parts[t].insert(*i);
+        } catch (...) {
+          errors[t] = std::current_exception();
+        }
+      });
+      std::advance(first, length);
+    }
+    for (std::thread &worker : workers)
+      worker.join();
+
+    for (std::exception_ptr &error : errors) {
+      if (error)
+        std::rethrow_exception(error);
+    }
+    for (FibHeap &part : parts) {
+      FIBHEAP_COUNT(m_stats.allocations += part.m_stats.allocations);
+      uniteWith(part);
+    }
+    FIBHEAP_CHECK();
+  }
+
   /**
    * constructs Fibonacci heap from initializer list
    * @param list list to constract heap from
    * @return constructed heap
    */
   FibHeap(std::initializer_list<Value> list)
-      : m_top(nullptr), m_number(0), m_size(0) {
+      : m_top(nullptr), m_number(0), m_size(0), m_parallelRoots(0),
+        m_consolidateThreads(1) {
     for (Value v : list)
       insert(v);
   }
@@ -263,6 +429,8 @@ public:
 
     m_size++;
     m_number++;
+    FIBHEAP_COUNT(notePeakRoots());
+    FIBHEAP_CHECK();
     return Handler(n);
   }
 
@@ -288,6 +456,7 @@ public:
       other.m_size = 0;
       other.m_number = 0;
 
+      FIBHEAP_CHECK();
       return;
     }
 
@@ -306,10 +475,12 @@ public:
 
     m_size += other.m_size;
     m_number += other.m_number;
+    FIBHEAP_COUNT(notePeakRoots());
 
     other.m_top = nullptr;
     other.m_size = 0;
     other.m_number = 0;
+    FIBHEAP_CHECK();
   }
 
   /**
@@ -327,6 +498,7 @@ public:
 
     if (size() == 1) {
       delete m_top;
+      FIBHEAP_COUNT(m_stats.deallocations++);
       m_top = nullptr;
       m_size = 0;
       m_number = 0;
@@ -343,12 +515,15 @@ public:
         left->m_right = child;
       }
 
+      // promoted children become unmarked roots
       for (unsigned i = 0; i < m_top->m_degree - 1; i++) {
         child->m_parent = nullptr;
+        child->m_mark = false;
         child = child->m_right;
       }
 
       child->m_parent = nullptr;
+      child->m_mark = false;
 
       if (right != m_top) {
         child->m_right = right;
@@ -363,14 +538,17 @@ public:
     }
 
     m_size--;
+    FIBHEAP_COUNT(notePeakRoots());
 
     delete m_top;
+    FIBHEAP_COUNT(m_stats.deallocations++);
     if (child)
       m_top = child;
     else
       m_top = left;
 
     consolidate();
+    FIBHEAP_CHECK();
   }
 
   /**
@@ -396,6 +574,7 @@ public:
     extract_top();
 
     h.m_exists = false;
+    FIBHEAP_CHECK();
   }
 
   /**
@@ -428,6 +607,7 @@ public:
     if (!compare(h.m_node->m_key, m_top->m_key)) {
       m_top = h.m_node;
     }
+    FIBHEAP_CHECK();
   }
 
   /**
@@ -438,6 +618,176 @@ public:
     std::swap(m_top, heap.m_top);
     std::swap(m_number, heap.m_number);
     std::swap(m_size, heap.m_size);
+    std::swap(m_parallelRoots, heap.m_parallelRoots);
+    std::swap(m_consolidateThreads, heap.m_consolidateThreads);
+  }
+
+  /**
+   * detaches one tree from the heap and returns it as a separate heap
+   * takes a root tree next to the top one, or a subtree of the top Node
+   * if the top is the only root, so the top value always stays
+   * relinking is O(1), counting Nodes of the tree is linear in its size
+   * Handlers of the moved values are valid for the returned heap
+   * @return heap with the detached tree (empty if the heap has < 2 values)
+   */
+  FibHeap splitTree() {
+    FibHeap result;
+    if (m_size < 2)
+      return result;
+
+    Node *tree;
+    if (m_number > 1) {
+      tree = m_top->m_right;
+      tree->m_left->m_right = tree->m_right;
+      tree->m_right->m_left = tree->m_left;
+      m_number--;
+    } else {
+      tree = m_top->m_child;
+      if (tree->m_right == tree) {
+        m_top->m_child = nullptr;
+      } else {
+        tree->m_left->m_right = tree->m_right;
+        tree->m_right->m_left = tree->m_left;
+        m_top->m_child = tree->m_right;
+      }
+      m_top->m_degree--;
+      tree->m_parent = nullptr;
+      tree->m_mark = false;
+    }
+    tree->m_left = tree;
+    tree->m_right = tree;
+
+    size_t count = countTree(tree);
+    m_size -= count;
+
+    result.m_top = tree;
+    result.m_number = 1;
+    result.m_size = count;
+    FIBHEAP_CHECK();
+    return result;
+  }
+
+  /**
+   * enables parallel consolidation of long root lists
+   * consolidate splits the root list between @threads threads whenever
+   * it contains at least @minRoots trees (e.g. after a large bulk insert)
+   * @param minRoots smallest root list consolidated in parallel, 0 disables
+   * @param threads number of threads, 0 means hardware concurrency
+   */
+  void setParallelConsolidation(size_t minRoots, unsigned threads) {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    m_parallelRoots = minRoots;
+    m_consolidateThreads = threads;
+  }
+
+  /**
+   * checks all invariants of the Fibonacci heap in O(n):
+   * circular lists of siblings, parent pointers, degrees, number of roots
+   * and Nodes, heap order, the top, unmarked roots, logarithmic degree bound
+   * and Handlers pointing back to their Nodes
+   * called after every modification if compiled with FIBHEAP_VALIDATE
+   * may throw exceptions (std::logic_error describing the violation)
+   */
+  void validate() const {
+    if (!m_top) {
+      if (m_size || m_number)
+        throw std::logic_error("Heap without top is not empty!");
+      return;
+    }
+
+    size_t nodes = 0;
+    const unsigned degreeBound = static_cast<unsigned>(maxDegree());
+    // first Node of a list of siblings and their parent
+    // the Nodes are not const, so Compare may take non-const references
+    std::vector<std::pair<Node *, Node *>> lists{{m_top, nullptr}};
+    while (!lists.empty()) {
+      Node *first = lists.back().first;
+      Node *parent = lists.back().second;
+      lists.pop_back();
+
+      size_t siblings = 0;
+      Node *current = first;
+      do {
+        // also stops on cycles which do not return to first
+        if (++nodes > m_size)
+          throw std::logic_error("Heap contains more Nodes than its size!");
+        siblings++;
+        if (!current->m_left || !current->m_right ||
+            current->m_right->m_left != current ||
+            current->m_left->m_right != current)
+          throw std::logic_error("Broken list of siblings!");
+        if (current->m_parent != parent)
+          throw std::logic_error("Wrong parent pointer!");
+        if (cmpFunction(parent ? parent->m_key : m_top->m_key,
+                        current->m_key))
+          throw std::logic_error("Heap order violated!");
+        if (!parent && current->m_mark)
+          throw std::logic_error("Marked root!");
+        if (current->m_degree > degreeBound)
+          throw std::logic_error("Degree above the logarithmic bound!");
+        if (current->m_handler && (current->m_handler->m_node != current ||
+                                   !current->m_handler->m_exists))
+          throw std::logic_error("Handler does not point to its Node!");
+        if (current->m_child)
+          lists.emplace_back(current->m_child, current);
+        else if (current->m_degree != 0)
+          throw std::logic_error("Degree does not match children!");
+        current = current->m_right;
+      } while (current != first);
+
+      if (siblings != (parent ? parent->m_degree : m_number))
+        throw std::logic_error(parent ? "Degree does not match children!"
+                                      : "Wrong number of roots!");
+    }
+    if (nodes != m_size)
+      throw std::logic_error("Heap contains fewer Nodes than its size!");
+  }
+
+  /**
+   * counters of operations performed by this heap object since its
+   * construction or the last resetStats (not moved or swapped with the
+   * values), all zero unless compiled with FIBHEAP_STATS
+   * @return copy of the counters
+   */
+  FibHeapStats stats() const {
+#ifdef FIBHEAP_STATS
+    return m_stats;
+#else
+    return FibHeapStats();
+#endif
+  }
+
+  /**
+   * sets all counters to zero
+   */
+  void resetStats() { FIBHEAP_COUNT(m_stats = FibHeapStats()); }
+
+  /**
+   * memory held by the heap, values owning other memory (e.g. std::string)
+   * are counted only by their sizeof
+   * @return bytes of Nodes, allocator slack and consolidation scratch
+   */
+  FibHeapMemory memory_usage() const {
+    FibHeapMemory memory;
+    memory.nodes = m_size * sizeof(Node);
+    memory.allocatorSlack =
+        m_size * (FibHeapMemory::chunk(sizeof(Node)) - sizeof(Node));
+    memory.scratch = scratchBytes();
+    return memory;
+  }
+
+  /**
+   * memory held by the heap including memory owned by the values,
+   * visits every Node
+   * @param payload function returning bytes owned by a value
+   * (without sizeof(Value))
+   * @return bytes of Nodes, payload, allocator slack and consolidation scratch
+   */
+  template <typename F> FibHeapMemory memory_usage(F payload) const {
+    FibHeapMemory memory = memory_usage();
+    forEachNode([&](const Node &n) { memory.payload += payload(n.m_key); });
+    return memory;
   }
 
 private:
@@ -477,6 +827,8 @@ private:
     child->m_mark = false;
 
     m_number++;
+    FIBHEAP_COUNT(m_stats.cuts++);
+    FIBHEAP_COUNT(notePeakRoots());
   }
 
   /**
@@ -493,17 +845,20 @@ private:
       if (!parent)
         break;
       cutBranch(node, parent);
+      FIBHEAP_COUNT(m_stats.cascadingCuts++);
       node = parent;
       parent = parent->m_parent;
     }
-    node->m_mark = true;
+    // roots stay unmarked
+    if (parent)
+      node->m_mark = true;
   }
 
   /**
    * computes max degree of all heap parts
    * @return max degree for heaps
    */
-  int maxDegree() {
+  int maxDegree() const {
     using namespace std;
     return static_cast<int>(
                ceil(log(static_cast<double>(m_size)) /
@@ -512,12 +867,58 @@ private:
            1;
   }
 
+  /**
+   *
+   * @return bytes of the tables allocated by consolidate for the current
+   * size and root list
+   */
+  size_t scratchBytes() const {
+    if (m_size == 0)
+      return 0;
+    const size_t table = static_cast<size_t>(maxDegree()) * sizeof(Node *);
+    if (!m_parallelRoots || m_number < m_parallelRoots ||
+        m_consolidateThreads <= 1)
+      return table;
+    // list of roots and one table per thread
+    const size_t threads = std::min<size_t>(m_consolidateThreads, m_number);
+    return m_number * sizeof(Node *) +
+           threads * (table + sizeof(std::vector<Node *>));
+  }
+
+  /**
+   * calls @visit for every Node (iteratively, so deep trees do not overflow
+   * the stack)
+   * @param visit function taking const Node &
+   */
+  template <typename F> void forEachNode(F &&visit) const {
+    if (!m_top)
+      return;
+    std::vector<const Node *> lists{m_top};
+    while (!lists.empty()) {
+      const Node *first = lists.back();
+      lists.pop_back();
+      const Node *current = first;
+      do {
+        visit(*current);
+        if (current->m_child)
+          lists.push_back(current->m_child);
+        current = current->m_right;
+      } while (current != first);
+    }
+  }
+
   /**
    * modifies the heap so that it does not contain two trees with the same
    * degree
    * ensures the amortized logatimic deletion and extract-top time
    */
   void consolidate() {
+    if (m_parallelRoots && m_number >= m_parallelRoots &&
+        m_consolidateThreads > 1) {
+      consolidateParallel();
+      return;
+    }
+
     std::vector<Node *> trees(maxDegree(), nullptr);
     Node *current = m_top;
 
@@ -555,6 +956,9 @@ private:
         son->m_parent = parent;
 
         parent->m_degree++;
+        FIBHEAP_COUNT(m_stats.links++);
+        FIBHEAP_COUNT(m_stats.maxDegree =
+                          std::max(m_stats.maxDegree, parent->m_degree));
         trees[degree] = nullptr;
         degree++;
         current_parent = parent;
@@ -575,6 +979,144 @@ private:
     }
   }
 
+  /**
+   * counts Nodes of a tree
+   * @param root root of the tree
+   * @return number of Nodes in the tree
+   */
+  size_t countTree(const Node *root) const {
+    size_t count = 1;
+    const Node *child = root->m_child;
+    for (unsigned i = 0; i < root->m_degree; i++) {
+      count += countTree(child);
+      child = child->m_right;
+    }
+    return count;
+  }
+
+  /**
+   * makes the tree with lower key a child of the other one
+   * the trees have to be detached from any list of siblings
+   * runs in parallel, so it is not counted in stats (consolidateParallel
+   * counts the links afterwards)
+   * @param first root of the first tree
+   * @param second root of the second tree
+   * @return root of the linked tree
+   */
+  Node *linkTrees(Node *first, Node *second) {
+    Node *parent = first;
+    Node *son = second;
+    if (cmpFunction(parent->m_key, son->m_key))
+      std::swap(parent, son);
+
+    if (!parent->m_child) {
+      parent->m_child = son;
+      son->m_right = son;
+      son->m_left = son;
+    } else {
+      son->m_left = parent->m_child->m_left;
+      son->m_right = parent->m_child;
+      parent->m_child->m_left->m_right = son;
+      parent->m_child->m_left = son;
+    }
+    son->m_parent = parent;
+    parent->m_degree++;
+    return parent;
+  }
+
+  /**
+   * adds detached tree to a table of trees indexed by degree
+   * links it with trees of the same degree until its slot is empty
+   * @param trees table of trees
+   * @param node root of the tree to add
+   */
+  void addTree(std::vector<Node *> &trees, Node *node) {
+    unsigned degree = node->m_degree;
+    while (trees[degree] != nullptr) {
+      node = linkTrees(node, trees[degree]);
+      trees[degree] = nullptr;
+      degree++;
+    }
+    trees[degree] = node;
+  }
+
+  /**
+   * parallel version of consolidate
+   * the root list is split into parts, every thread links trees of its part
+   * into its own table of degrees, the tables are merged at the end
+   */
+  void consolidateParallel() {
+    FIBHEAP_COUNT(const size_t rootsBefore = m_number);
+    std::vector<Node *> roots;
+    roots.reserve(m_number);
+    Node *current = m_top;
+    for (unsigned i = 0; i < m_number; i++) {
+      roots.push_back(current);
+      current = current->m_right;
+    }
+
+    const size_t degrees = static_cast<size_t>(maxDegree());
+    const unsigned threads = static_cast<unsigned>(
+        std::min<size_t>(m_consolidateThreads, roots.size()));
+    const size_t chunk = (roots.size() + threads - 1) / threads;
+    std::vector<std::vector<Node *>> tables(
+        threads, std::vector<Node *>(degrees, nullptr));
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; ++t) {
+      workers.emplace_back([this, &roots, &tables, &errors, t, chunk]() {
+        try {
+          size_t begin = std::min(roots.size(), t * chunk);
+          size_t end = std::min(roots.size(), begin + chunk);
+          for (size_t i = begin; i < end; ++i)
+            addTree(tables[t], roots[i]);
+        } catch (...) {
+          errors[t] = std::current_exception();
+        }
+      });
+    }
+    for (std::thread &worker : workers)
+      worker.join();
+
+    for (std::exception_ptr &error : errors) {
+      if (error)
+        std::rethrow_exception(error);
+    }
+
+    for (unsigned t = 1; t < threads; ++t) {
+      for (Node *n : tables[t]) {
+        if (n)
+          addTree(tables[0], n);
+      }
+    }
+
+    m_top = nullptr;
+    m_number = 0;
+    for (Node *n : tables[0]) {
+      if (!n)
+        continue;
+      if (!m_top) {
+        m_top = n;
+        n->m_left = n;
+        n->m_right = n;
+      } else {
+        n->m_left = m_top->m_left;
+        n->m_right = m_top;
+        m_top->m_left->m_right = n;
+        m_top->m_left = n;
+        if (compare(m_top->m_key, n->m_key))
+          m_top = n;
+      }
+      m_number++;
+      FIBHEAP_COUNT(m_stats.maxDegree =
+                        std::max(m_stats.maxDegree, n->m_degree));
+    }
+    // every link made one root a child, every link compared once
+    FIBHEAP_COUNT(m_stats.links += rootsBefore - m_number);
+    FIBHEAP_COUNT(m_stats.comparisons += rootsBefore - m_number);
+  }
+
   /**
    * creating and copying every node to new heap
    *
@@ -589,6 +1131,7 @@ private:
 
     if (from.m_child) {
       to.m_child = new Node(*from.m_child);
+      FIBHEAP_COUNT(m_stats.allocations++);
       to.m_child->m_parent = &to;
 
       copyRec(*from.m_child, *to.m_child, from.m_child, to.m_child);
@@ -601,6 +1144,7 @@ private:
       to.m_right->m_left = &to;
     } else {
       to.m_right = new Node(*from.m_right);
+      FIBHEAP_COUNT(m_stats.allocations++);
       to.m_right->m_left = &to;
 
       copyRec(*from.m_right, *to.m_right, initial, copyInitial);
@@ -611,6 +1155,15 @@ private:
     to.m_mark = from.m_mark;
   }
 
+#ifdef FIBHEAP_STATS
+  /**
+   * updates peakRoots after the root list grew
+   */
+  void notePeakRoots() {
+    m_stats.peakRoots = std::max<size_t>(m_stats.peakRoots, m_number);
+  }
+#endif
+
   /**
    * compares two values with function if the heap
    * @param a first value
@@ -618,10 +1171,14 @@ private:
    * @return true/false according to Compare function
    */
   bool compare(const Value &a, const Value &b) const {
+    FIBHEAP_COUNT(m_stats.comparisons++);
     return cmpFunction(a, b);
   }
 
-  bool compare(Value &a, Value &b) { return cmpFunction(a, b); }
+  bool compare(Value &a, Value &b) {
+    FIBHEAP_COUNT(m_stats.comparisons++);
+    return cmpFunction(a, b);
+  }
 
   /**
    * implementation of insert for rvalue values
@@ -630,6 +1187,7 @@ private:
    */
   template <typename T = Value> Node *insert_help(T &&t, std::false_type) {
     auto n = new Node(std::move(t));
+    FIBHEAP_COUNT(m_stats.allocations++);
     return n;
   }
 
@@ -640,6 +1198,7 @@ private:
    */
   template <typename T = Value> Node *insert_help(const T &t, std::true_type) {
     auto n = new Node(t);
+    FIBHEAP_COUNT(m_stats.allocations++);
     return n;
   }
 
@@ -653,18 +1212,30 @@ private:
     if (current == top) {
       if (current->m_parent)
         current->m_parent->m_child = nullptr;
+      if (current->m_handler)
+        current->m_handler->m_exists = false;
       delete current;
+      FIBHEAP_COUNT(m_stats.deallocations++);
       return;
     }
     top->m_left = current->m_left;
     current->m_left->m_right = top;
+    if (current->m_handler)
+      current->m_handler->m_exists = false;
     delete current;
+    FIBHEAP_COUNT(m_stats.deallocations++);
   }
 
   static Compare cmpFunction;
   Node *m_top;
   unsigned m_number;
   size_t m_size;
+  size_t m_parallelRoots;
+  unsigned m_consolidateThreads;
+#ifdef FIBHEAP_STATS
+  // mutable, so comparisons of the const compare are counted
+  mutable FibHeapStats m_stats = FibHeapStats();
+#endif
 };
 
 template <typename Value, typename Compare>
@@ -0,0 +1,600 @@
+#ifndef FIBHEAP_GRAPH_HPP
+#define FIBHEAP_GRAPH_HPP
+
+#include "FibHeap.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+const unsigned MY_MAX = 1000000000;
+
+/**
+ * Structure representing a single vertex in a graph
+ */
+struct Vertex {
+  Vertex(unsigned id) : dist(MY_MAX), ID(id) {}
+  Vertex(unsigned id, unsigned distance) : dist(distance), ID(id) {}
+
+  unsigned dist;
+  unsigned ID;
+};
+
+/**
+ * Structure for Vertex comparison
+ */
+struct cmpVertex {
+  bool operator()(const Vertex &first, const Vertex &second) {
+    return second.dist == first.dist ? first.ID > second.ID
+                                     : first.dist > second.dist;
+  }
+};
+
+/**
+ * Graph represented using adjacency matrix
+ */
+struct Graph {
+  Graph(size_t s) : matrix(s * s, 0), size(s) {}
+
+  int at(size_t row, size_t col) const { return matrix[row * size + col]; }
+
+  void generateSparseGraph(int max) { generateGraph(0.33, max); }
+  void generateDenseGraph(int max) { generateGraph(0.66, max); }
+
+  /**
+   * Generates adjacency matrix
+   * @param fill - a number from 0 to 1
+   *             - specifies how many edges should the graph have
+   *             (0 meaning none and 1 meaning all pairs of vertices should have
+   * an edge)
+   * @param max - maximum weight of edges
+   */
+  void generateGraph(float fill, int max) {
+    std::random_device rd;
+    std::mt19937 generator;
+    unsigned x = rd();
+    generator.seed(x);
+    std::cout << x << std::endl;
+
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t j = 0; j < i; ++j) {
+        if (generator() % 1000 < fill * 1000) {
+          matrix.at(i * size + j) = (generator() % max) + 1;
+          matrix.at(j * size + i) = matrix.at(i * size + j);
+        } else {
+          matrix.at(i * size + j) = MY_MAX;
+          matrix.at(j * size + i) = MY_MAX;
+        }
+      }
+    }
+  }
+
+  std::vector<unsigned> shortestPathPriorityQueue(unsigned fromID,
+                                                 bool showResult,
+                                                 bool showTime) {
+    using namespace std;
+    chrono::time_point<chrono::steady_clock> start, end;
+    chrono::duration<double> duration(0);
+
+    std::priority_queue<Vertex, std::vector<Vertex>, cmpVertex> pQueue;
+    std::vector<unsigned> distances(size, MY_MAX);
+    for (unsigned i = 0; i < size; ++i) {
+      pQueue.push(Vertex(i));
+    }
+    pQueue.push(Vertex(fromID, 0));
+    distances[fromID] = 0;
+    assert(pQueue.top().dist == 0);
+
+    start = chrono::steady_clock::now();
+    unsigned u;
+
+    while (!pQueue.empty()) {
+      u = pQueue.top().ID;
+      pQueue.pop();
+      for (unsigned v = 0; v < size; ++v) {
+        if (distances[v] > distances[u] + at(u, v)) {
+          distances[v] = distances[u] + at(u, v);
+          pQueue.push(Vertex(v, distances[v]));
+        }
+      }
+    }
+
+    end = chrono::steady_clock::now();
+    duration = end - start;
+
+    if (showResult) {
+      std::cout << "Shortest distances from vertex " << fromID
+                << "(priority queue)" << std::endl;
+      for (unsigned i = 0; i < size; ++i) {
+        std::cout << "ID: " << i << "    d = " << distances[i] << std::endl;
+      }
+    }
+
+    if (showTime) {
+      cout << "Shortest path (Priority queue)" << endl;
+      cout << "Graph size: " << size << endl;
+      cout << "Time: " << duration.count() << "s" << endl;
+    }
+    return distances;
+  };
+
+  std::vector<unsigned> shortestPathFibHeap(unsigned fromID, bool showResult,
+                                            bool showTime) {
+    using namespace std;
+    chrono::time_point<chrono::steady_clock> start, end;
+    chrono::duration<double> duration(0);
+
+    FibHeap<Vertex, cmpVertex> fibHeap;
+    std::vector<FibHeap<Vertex, cmpVertex>::Handler> handlers;
+    std::vector<unsigned> distances(size, MY_MAX);
+    for (unsigned i = 0; i < size; ++i) {
+      handlers.push_back(fibHeap.insert(Vertex(i, MY_MAX)));
+    }
+    fibHeap.increase_key(handlers[fromID], Vertex(fromID, 0));
+    // std::cout << "after init" << std::endl;
+
+    start = chrono::steady_clock::now();
+
+    unsigned ID, distance;
+    while (!fibHeap.empty()) {
+      ID = fibHeap.top().ID;
+      distance = fibHeap.top().dist;
+      distances[ID] = distance;
+      // extracted before relaxing, a zero weight edge could make its
+      // target the new top
+      fibHeap.extract_top();
+      for (unsigned v = 0; v < size; ++v) {
+        if (handlers[v].isValid() &&
+            handlers[v].value().dist > distance + at(ID, v)) {
+          fibHeap.increase_key(handlers[v], Vertex(v, distance + at(ID, v)));
+        }
+      }
+    }
+
+    end = chrono::steady_clock::now();
+    duration = end - start;
+
+    if (showResult) {
+      std::cout << "Shortest distances from vertex " << fromID
+                << "(Fibonacci heap)" << std::endl;
+      for (unsigned i = 0; i < size; ++i) {
+        std::cout << "ID: " << i << "    d = " << distances[i] << std::endl;
+      }
+      std::cout << "End of results" << std::endl;
+    }
+    if (showTime) {
+      cout << "Shortest path (Fibonacci heap)" << endl;
+      cout << "Graph size: " << size << endl;
+      cout << "Time: " << duration.count() << "s" << endl;
+    }
+    return distances;
+  }
+
+  std::vector<int> matrix;
+  size_t size;
+};
+
+/**
+ * Graph represented in compressed sparse row format
+ * edges going out of vertex u are stored at positions
+ * offsets()[u] .. offsets()[u + 1] - 1 of targets() and weights()
+ * the arrays are immutable and shared between copies of the graph
+ * weights have to be lower than MY_MAX
+ */
+class CsrGraph {
+public:
+  /**
+   * Single directed edge
+   */
+  struct Edge {
+    unsigned from;
+    unsigned to;
+    unsigned weight;
+  };
+
+  /**
+   * creates graph without vertices
+   */
+  CsrGraph()
+      : CsrGraph(std::vector<uint64_t>(1, 0), std::vector<unsigned>(),
+                 std::vector<unsigned>()) {}
+
+  /**
+   * creates graph from its arrays
+   * may throw exceptions (for inconsistent arrays)
+   * @param offsets size + 1 positions of the first edge of every vertex
+   * @param targets target vertex of every edge
+   * @param weights weight of every edge
+   */
+  CsrGraph(std::vector<uint64_t> offsets, std::vector<unsigned> targets,
+           std::vector<unsigned> weights)
+      : m_storage(), m_size(0), m_edges(0), m_offsets(nullptr),
+        m_targets(nullptr), m_weights(nullptr) {
+    if (offsets.empty() || offsets.back() != targets.size() ||
+        targets.size() != weights.size())
+      throw std::invalid_argument("Inconsistent CSR arrays!");
+
+    auto arrays = std::make_shared<Arrays>();
+    arrays->offsets = std::move(offsets);
+    arrays->targets = std::move(targets);
+    arrays->weights = std::move(weights);
+    attach(arrays, arrays->offsets.size() - 1, arrays->targets.size(),
+           arrays->offsets.data(), arrays->targets.data(),
+           arrays->weights.data());
+  }
+
+  /**
+   * creates graph from a list of directed edges
+   * edges of every vertex keep their order from the list
+   * may throw exceptions (for edges with vertices out of range)
+   * @param vertices number of vertices
+   * @param edges list of edges
+   */
+  CsrGraph(size_t vertices, const std::vector<Edge> &edges)
+      : CsrGraph(fromEdges(vertices, edges)) {}
+
+  /**
+   * creates graph over arrays owned by another object (e.g. a mapped file)
+   * the arrays are not copied and have to live as long as @owner
+   * @param owner object keeping the arrays alive
+   * @param vertices number of vertices
+   * @param edges number of directed edges
+   * @param offsets vertices + 1 positions of the first edge of every vertex
+   * @param targets target vertex of every edge
+   * @param weights weight of every edge
+   * @return graph using the arrays
+   */
+  static CsrGraph external(std::shared_ptr<const void> owner, size_t vertices,
+                           size_t edges, const uint64_t *offsets,
+                           const unsigned *targets, const unsigned *weights) {
+    CsrGraph graph;
+    graph.attach(std::move(owner), vertices, edges, offsets, targets,
+                 weights);
+    return graph;
+  }
+
+  // copies share the immutable arrays
+  CsrGraph(const CsrGraph &) = default;
+  CsrGraph &operator=(const CsrGraph &) = default;
+
+  /**
+   * converts adjacency matrix to CSR graph
+   * entries with MY_MAX (no edge) and the diagonal are skipped
+   * @param graph graph to convert
+   * @return converted graph
+   */
+  static CsrGraph fromMatrix(const Graph &graph) {
+    std::vector<uint64_t> offsets(graph.size + 1, 0);
+    std::vector<unsigned> targets, weights;
+    for (size_t u = 0; u < graph.size; ++u) {
+      for (size_t v = 0; v < graph.size; ++v) {
+        unsigned weight = static_cast<unsigned>(graph.at(u, v));
+        if (u != v && weight < MY_MAX) {
+          targets.push_back(static_cast<unsigned>(v));
+          weights.push_back(weight);
+        }
+      }
+      offsets[u + 1] = targets.size();
+    }
+    return CsrGraph(std::move(offsets), std::move(targets),
+                    std::move(weights));
+  }
+
+  /**
+   *
+   * @return number of vertices
+   */
+  size_t size() const { return m_size; }
+
+  /**
+   *
+   * @return number of directed edges
+   */
+  size_t edgeCount() const { return m_edges; }
+
+  /**
+   * creates graph with all edges reversed
+   * @return reversed graph
+   */
+  CsrGraph reversed() const {
+    std::vector<uint64_t> offsets(m_size + 1, 0);
+    for (size_t e = 0; e < m_edges; ++e)
+      offsets[m_targets[e] + 1]++;
+    for (size_t u = 0; u < m_size; ++u)
+      offsets[u + 1] += offsets[u];
+
+    std::vector<uint64_t> position(offsets.begin(), offsets.end() - 1);
+    std::vector<unsigned> targets(m_edges), weights(m_edges);
+    for (size_t u = 0; u < m_size; ++u) {
+      for (uint64_t e = m_offsets[u]; e < m_offsets[u + 1]; ++e) {
+        uint64_t r = position[m_targets[e]]++;
+        targets[r] = static_cast<unsigned>(u);
+        weights[r] = m_weights[e];
+      }
+    }
+    return CsrGraph(std::move(offsets), std::move(targets),
+                    std::move(weights));
+  }
+
+  const uint64_t *offsets() const { return m_offsets; }
+  const unsigned *targets() const { return m_targets; }
+  const unsigned *weights() const { return m_weights; }
+
+  std::vector<unsigned> shortestPathPriorityQueue(unsigned fromID,
+                                                  bool showResult,
+                                                  bool showTime) const {
+    using namespace std;
+    chrono::time_point<chrono::steady_clock> start, end;
+    chrono::duration<double> duration(0);
+
+    std::priority_queue<Vertex, std::vector<Vertex>, cmpVertex> pQueue;
+    std::vector<unsigned> distances(m_size, MY_MAX);
+    pQueue.push(Vertex(fromID, 0));
+    distances[fromID] = 0;
+
+    start = chrono::steady_clock::now();
+
+    while (!pQueue.empty()) {
+      Vertex top = pQueue.top();
+      pQueue.pop();
+      if (top.dist > distances[top.ID])
+        continue;
+      for (uint64_t e = m_offsets[top.ID]; e < m_offsets[top.ID + 1]; ++e) {
+        unsigned v = m_targets[e];
+        if (distances[v] > top.dist + m_weights[e]) {
+          distances[v] = top.dist + m_weights[e];
+          pQueue.push(Vertex(v, distances[v]));
+        }
+      }
+    }
+
+    end = chrono::steady_clock::now();
+    duration = end - start;
+
+    if (showResult) {
+      std::cout << "Shortest distances from vertex " << fromID
+                << "(priority queue, CSR)" << std::endl;
+      for (unsigned i = 0; i < m_size; ++i) {
+        std::cout << "ID: " << i << "    d = " << distances[i] << std::endl;
+      }
+    }
+    if (showTime) {
+      cout << "Shortest path (Priority queue, CSR)" << endl;
+      cout << "Graph size: " << m_size << "   Edges: " << m_edges << endl;
+      cout << "Time: " << duration.count() << "s" << endl;
+    }
+    return distances;
+  }
+
+  std::vector<unsigned> shortestPathFibHeap(unsigned fromID, bool showResult,
+                                            bool showTime) const {
+    using namespace std;
+    chrono::time_point<chrono::steady_clock> start, end;
+    chrono::duration<double> duration(0);
+
+    FibHeap<Vertex, cmpVertex> fibHeap;
+    std::vector<FibHeap<Vertex, cmpVertex>::Handler> handlers;
+    std::vector<unsigned> distances(m_size, MY_MAX);
+    handlers.reserve(m_size);
+    for (unsigned i = 0; i < m_size; ++i) {
+      handlers.push_back(fibHeap.insert(Vertex(i, MY_MAX)));
+    }
+    fibHeap.increase_key(handlers[fromID], Vertex(fromID, 0));
+
+    start = chrono::steady_clock::now();
+
+    unsigned ID, distance;
+    while (!fibHeap.empty()) {
+      ID = fibHeap.top().ID;
+      distance = fibHeap.top().dist;
+      distances[ID] = distance;
+      // extracted before relaxing, a zero weight edge could make its
+      // target the new top
+      fibHeap.extract_top();
+      for (uint64_t e = m_offsets[ID]; e < m_offsets[ID + 1]; ++e) {
+        unsigned v = m_targets[e];
+        if (handlers[v].isValid() &&
+            handlers[v].value().dist > distance + m_weights[e]) {
+          fibHeap.increase_key(handlers[v],
+                               Vertex(v, distance + m_weights[e]));
+        }
+      }
+    }
+
+    end = chrono::steady_clock::now();
+    duration = end - start;
+
+    if (showResult) {
+      std::cout << "Shortest distances from vertex " << fromID
+                << "(Fibonacci heap, CSR)" << std::endl;
+      for (unsigned i = 0; i < m_size; ++i) {
+        std::cout << "ID: " << i << "    d = " << distances[i] << std::endl;
+      }
+      std::cout << "End of results" << std::endl;
+    }
+    if (showTime) {
+      cout << "Shortest path (Fibonacci heap, CSR)" << endl;
+      cout << "Graph size: " << m_size << "   Edges: " << m_edges << endl;
+      cout << "Time: " << duration.count() << "s" << endl;
+    }
+    return distances;
+  }
+
+  /**
+   * Delta-stepping single source shortest paths
+   * Vertices are kept in buckets of width @delta by their tentative distance.
+   * Buckets are settled in increasing order; edges of the current bucket are
+   * scanned in parallel and the resulting relaxation requests are applied
+   * between the parallel phases, so the result equals the Dijkstra one.
+   * @param fromID source vertex
+   * @param delta width of one bucket (light edges have weight <= delta)
+   * @param pool threads used for edge relaxation
+   * @return distances from the source vertex
+   */
+  std::vector<unsigned> shortestPathDeltaStepping(unsigned fromID,
+                                                  unsigned delta,
+                                                  ThreadPool &pool,
+                                                  bool showResult,
+                                                  bool showTime) const {
+    using namespace std;
+    using Request = pair<unsigned, unsigned>;
+    chrono::time_point<chrono::steady_clock> start, end;
+    chrono::duration<double> duration(0);
+
+    if (delta == 0)
+      delta = 1;
+
+    std::vector<unsigned> distances(m_size, MY_MAX);
+    std::vector<std::vector<unsigned>> buckets(1);
+    std::vector<std::vector<Request>> requests(pool.size());
+    std::vector<size_t> settledIn(m_size, 0);
+    std::vector<unsigned> frontier, settled;
+
+    start = chrono::steady_clock::now();
+
+    auto relax = [&](unsigned v, unsigned distance) {
+      if (distance < distances[v]) {
+        distances[v] = distance;
+        size_t bucket = distance / delta;
+        if (bucket >= buckets.size())
+          buckets.resize(bucket + 1);
+        buckets[bucket].push_back(v);
+      }
+    };
+
+    // scans edges of @vertices in parallel, light or heavy ones only
+    auto relaxEdges = [&](const std::vector<unsigned> &vertices, bool light) {
+      pool.parallelFor(vertices.size(), [&](size_t begin, size_t stop,
+                                            unsigned worker) {
+        std::vector<Request> &local = requests[worker];
+        const unsigned *current = distances.data();
+        for (size_t i = begin; i < stop; ++i) {
+          const unsigned u = vertices[i];
+          const unsigned base = current[u];
+          for (uint64_t e = m_offsets[u]; e < m_offsets[u + 1]; ++e) {
+            const unsigned v = m_targets[e];
+            const unsigned weight = m_weights[e];
+            if ((weight <= delta) != light || current[v] <= base + weight)
+              continue;
+            local.push_back(Request(v, base + weight));
+          }
+        }
+      });
+      for (std::vector<Request> &local : requests) {
+        for (const Request &r : local)
+          relax(r.first, r.second);
+        local.clear();
+      }
+    };
+
+    relax(fromID, 0);
+    for (size_t i = 0; i < buckets.size(); ++i) {
+      settled.clear();
+      while (!buckets[i].empty()) {
+        frontier.clear();
+        for (unsigned v : buckets[i]) {
+          // skips stale entries and duplicates within one round
+          if (distances[v] / delta != i || settledIn[v] == i + 1)
+            continue;
+          settledIn[v] = i + 1;
+          frontier.push_back(v);
+        }
+        buckets[i].clear();
+        relaxEdges(frontier, true);
+        settled.insert(settled.end(), frontier.begin(), frontier.end());
+        for (unsigned v : frontier)
+          settledIn[v] = 0;
+      }
+      std::sort(settled.begin(), settled.end());
+      settled.erase(std::unique(settled.begin(), settled.end()),
+                    settled.end());
+      relaxEdges(settled, false);
+    }
+
+    end = chrono::steady_clock::now();
+    duration = end - start;
+
+    if (showResult) {
+      std::cout << "Shortest distances from vertex " << fromID
+                << "(delta-stepping, CSR)" << std::endl;
+      for (unsigned i = 0; i < m_size; ++i) {
+        std::cout << "ID: " << i << "    d = " << distances[i] << std::endl;
+      }
+      std::cout << "End of results" << std::endl;
+    }
+    if (showTime) {
+      cout << "Shortest path (delta-stepping, CSR, " << pool.size()
+           << " threads)" << endl;
+      cout << "Graph size: " << m_size << "   Edges: " << m_edges << endl;
+      cout << "Time: " << duration.count() << "s" << endl;
+    }
+    return distances;
+  }
+
+private:
+  /**
+   * owned arrays of a graph built in memory
+   */
+  struct Arrays {
+    Arrays() : offsets(), targets(), weights() {}
+
+    std::vector<uint64_t> offsets;
+    std::vector<unsigned> targets;
+    std::vector<unsigned> weights;
+  };
+
+  /**
+   * sorts edges by their source vertex (counting sort)
+   * @param vertices number of vertices
+   * @param edges list of edges
+   * @return graph with the edges
+   */
+  static CsrGraph fromEdges(size_t vertices, const std::vector<Edge> &edges) {
+    std::vector<uint64_t> offsets(vertices + 1, 0);
+    for (const Edge &edge : edges) {
+      if (edge.from >= vertices || edge.to >= vertices)
+        throw std::invalid_argument("Edge vertex out of range!");
+      offsets[edge.from + 1]++;
+    }
+    for (size_t u = 0; u < vertices; ++u)
+      offsets[u + 1] += offsets[u];
+
+    std::vector<uint64_t> position(offsets.begin(), offsets.end() - 1);
+    std::vector<unsigned> targets(edges.size()), weights(edges.size());
+    for (const Edge &edge : edges) {
+      uint64_t e = position[edge.from]++;
+      targets[e] = edge.to;
+      weights[e] = edge.weight;
+    }
+    return CsrGraph(std::move(offsets), std::move(targets),
+                    std::move(weights));
+  }
+
+  void attach(std::shared_ptr<const void> storage, size_t vertices,
+              size_t edges, const uint64_t *offsets, const unsigned *targets,
+              const unsigned *weights) {
+    m_storage = std::move(storage);
+    m_size = vertices;
+    m_edges = edges;
+    m_offsets = offsets;
+    m_targets = targets;
+    m_weights = weights;
+  }
+
+  std::shared_ptr<const void> m_storage;
+  size_t m_size;
+  size_t m_edges;
+  const uint64_t *m_offsets;
+  const unsigned *m_targets;
+  const unsigned *m_weights;
+};
+
+#endif // FIBHEAP_GRAPH_HPP
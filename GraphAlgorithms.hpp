@@ -0,0 +1,164 @@
+#ifndef FIBHEAP_GRAPHALGORITHMS_HPP
+#define FIBHEAP_GRAPHALGORITHMS_HPP
+
+#include "Graph.hpp"
+#include "HeapEngines.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Minimum spanning forest
+ * parent is MY_MAX for the root of every component
+ */
+struct SpanningTree {
+  unsigned long long weight;
+  std::vector<unsigned> parent;
+  size_t components;
+};
+
+/**
+ * Prim's (Jarnik's) algorithm
+ * grows the tree from vertex 0, the key of a vertex outside the tree is the
+ * lightest edge connecting it to the tree and is lowered whenever a lighter
+ * edge is found; unreached vertices start new components
+ * the graph has to be symmetric (every edge stored in both directions)
+ * @param graph graph to span
+ * @param engine priority queue of vertices (see HeapEngines.hpp)
+ * @return minimum spanning forest
+ */
+template <typename Engine>
+SpanningTree minimumSpanningTree(const CsrGraph &graph, Engine &engine) {
+  const size_t size = graph.size();
+  SpanningTree tree{0, std::vector<unsigned>(size, MY_MAX), 0};
+  std::vector<bool> inTree(size, false);
+  engine.reset(size);
+
+  for (unsigned root = 0; root < size; ++root) {
+    if (inTree[root])
+      continue;
+    tree.components++;
+    engine.offer(root, 0);
+
+    while (!engine.empty()) {
+      unsigned u = engine.top();
+      tree.weight += engine.topKey();
+      engine.pop();
+      inTree[u] = true;
+
+      for (uint64_t e = graph.offsets()[u]; e < graph.offsets()[u + 1]; ++e) {
+        unsigned v = graph.targets()[e];
+        if (!inTree[v] && engine.offer(v, graph.weights()[e]))
+          tree.parent[v] = u;
+      }
+    }
+  }
+  return tree;
+}
+
+/**
+ * Prim's algorithm with the Fibonacci heap engine
+ * @param graph graph to span
+ * @return minimum spanning forest
+ */
+inline SpanningTree minimumSpanningTree(const CsrGraph &graph) {
+  FibHeapEngine<unsigned> engine;
+  return minimumSpanningTree(graph, engine);
+}
+
+/**
+ * Global minimum cut
+ * side holds the vertices of one side of the cut
+ */
+struct MinimumCut {
+  unsigned long long weight;
+  std::vector<unsigned> side;
+};
+
+/**
+ * Stoer-Wagner algorithm
+ * every phase orders the remaining vertices by maximum adjacency: the key of
+ * a vertex is minus the total weight of its edges to the vertices ordered so
+ * far, so every ordered vertex lowers the keys of its neighbours; the last
+ * two vertices are merged and the weight of the last one is a candidate cut
+ * the graph has to be symmetric (every edge stored in both directions)
+ * may throw exceptions (for graphs with less than 2 vertices)
+ * @param graph graph to cut
+ * @param engine priority queue of vertices with long long keys
+ * @return minimum cut
+ */
+template <typename Engine>
+MinimumCut minimumCut(const CsrGraph &graph, Engine &engine) {
+  const size_t size = graph.size();
+  if (size < 2)
+    throw std::invalid_argument("Minimum cut needs at least 2 vertices!");
+
+  // adjacency of merged vertices, members of every merged vertex
+  std::vector<std::unordered_map<unsigned, long long>> adjacency(size);
+  std::vector<std::vector<unsigned>> members(size);
+  std::vector<unsigned> active(size);
+  for (unsigned u = 0; u < size; ++u) {
+    for (uint64_t e = graph.offsets()[u]; e < graph.offsets()[u + 1]; ++e) {
+      if (graph.targets()[e] != u)
+        adjacency[u][graph.targets()[e]] += graph.weights()[e];
+    }
+    members[u].push_back(u);
+    active[u] = u;
+  }
+
+  MinimumCut cut{static_cast<unsigned long long>(-1), {}};
+  std::vector<long long> connection(size);
+  while (active.size() > 1) {
+    engine.reset(size);
+    for (unsigned v : active) {
+      connection[v] = 0;
+      engine.offer(v, 0);
+    }
+
+    unsigned previous = active.front(), last = active.front();
+    while (!engine.empty()) {
+      previous = last;
+      last = engine.top();
+      engine.pop();
+      for (const auto &edge : adjacency[last]) {
+        connection[edge.first] += edge.second;
+        engine.offer(edge.first, -connection[edge.first]);
+      }
+    }
+
+    unsigned long long phaseCut =
+        static_cast<unsigned long long>(connection[last]);
+    if (phaseCut < cut.weight) {
+      cut.weight = phaseCut;
+      cut.side = members[last];
+    }
+
+    // merge last into previous
+    for (const auto &edge : adjacency[last]) {
+      adjacency[edge.first].erase(last);
+      if (edge.first != previous) {
+        adjacency[previous][edge.first] += edge.second;
+        adjacency[edge.first][previous] += edge.second;
+      }
+    }
+    adjacency[last].clear();
+    members[previous].insert(members[previous].end(), members[last].begin(),
+                             members[last].end());
+    members[last].clear();
+    active.erase(std::find(active.begin(), active.end(), last));
+  }
+  return cut;
+}
+
+/**
+ * Stoer-Wagner algorithm with the Fibonacci heap engine
+ * @param graph graph to cut
+ * @return minimum cut
+ */
+inline MinimumCut minimumCut(const CsrGraph &graph) {
+  FibHeapEngine<long long> engine;
+  return minimumCut(graph, engine);
+}
+
+#endif // FIBHEAP_GRAPHALGORITHMS_HPP
@@ -0,0 +1,239 @@
+#ifndef FIBHEAP_GRAPHGENERATORS_HPP
+#define FIBHEAP_GRAPHGENERATORS_HPP
+
+#include "Graph.hpp"
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Position of a vertex in the plane
+ */
+struct Point {
+  double x;
+  double y;
+};
+
+/**
+ * Edge list produced by the generators
+ * every undirected edge is stored as two directed edges
+ * coordinates are empty for graphs without geometry
+ */
+struct GeneratedGraph {
+  GeneratedGraph() : vertices(0), edges(), coordinates() {}
+
+  CsrGraph toCsr() const { return CsrGraph(vertices, edges); }
+
+  size_t vertices;
+  std::vector<CsrGraph::Edge> edges;
+  std::vector<Point> coordinates;
+};
+
+/**
+ * adds undirected edge as two directed edges
+ */
+inline void addUndirectedEdge(GeneratedGraph &graph, unsigned u, unsigned v,
+                              unsigned weight) {
+  graph.edges.push_back(CsrGraph::Edge{u, v, weight});
+  graph.edges.push_back(CsrGraph::Edge{v, u, weight});
+}
+
+/**
+ * checks that weights from 1 to @max can be drawn
+ */
+inline void checkMaxWeight(unsigned max) {
+  if (max == 0)
+    throw std::invalid_argument("Maximum weight must be positive!");
+}
+
+/**
+ * Generates Erdos-Renyi graph G(n, m)
+ * edges are drawn uniformly with replacement (self-loops are redrawn),
+ * so the graph may contain a few parallel edges
+ * @param vertices number of vertices (at least 2)
+ * @param edges number of undirected edges
+ * @param max maximum weight of edges (at least 1)
+ * @param seed seed of the random generator
+ * @return generated graph
+ * @throws std::invalid_argument if vertices < 2 or max == 0
+ */
+inline GeneratedGraph generateErdosRenyi(size_t vertices, size_t edges,
+                                         unsigned max, unsigned seed) {
+  if (vertices < 2)
+    throw std::invalid_argument("Erdos-Renyi graph needs 2 vertices!");
+  checkMaxWeight(max);
+  std::mt19937 generator(seed);
+  GeneratedGraph graph;
+  graph.vertices = vertices;
+  graph.edges.reserve(2 * edges);
+
+  for (size_t i = 0; i < edges; ++i) {
+    unsigned u = static_cast<unsigned>(generator() % vertices);
+    unsigned v = static_cast<unsigned>(generator() % vertices);
+    while (v == u)
+      v = static_cast<unsigned>(generator() % vertices);
+    addUndirectedEdge(graph, u, v, (generator() % max) + 1);
+  }
+  return graph;
+}
+
+/**
+ * Generates random geometric graph in the unit square
+ * vertices closer than a radius are connected, the radius is chosen so
+ * the expected degree equals @averageDegree; the weight of an edge is its
+ * length multiplied by @scale and rounded up (at least 1)
+ * @param vertices number of vertices
+ * @param averageDegree expected degree of a vertex (positive)
+ * @param scale multiplier of edge lengths
+ * @param seed seed of the random generator
+ * @return generated graph with coordinates
+ * @throws std::invalid_argument if averageDegree is not positive
+ */
+inline GeneratedGraph generateGeometric(size_t vertices, double averageDegree,
+                                        double scale, unsigned seed) {
+  if (!(averageDegree > 0))
+    throw std::invalid_argument("Average degree must be positive!");
+  std::mt19937 generator(seed);
+  GeneratedGraph graph;
+  graph.vertices = vertices;
+  graph.coordinates.resize(vertices);
+  for (Point &p : graph.coordinates) {
+    p.x = generator() / 4294967296.0;
+    p.y = generator() / 4294967296.0;
+  }
+
+  const double pi = std::acos(-1.0);
+  const double radius = std::sqrt(averageDegree / (pi * vertices));
+  const size_t side = std::max<size_t>(1, static_cast<size_t>(1 / radius));
+
+  // points sorted into side x side cells (counting sort)
+  auto cellOf = [&](const Point &p) {
+    size_t cx = std::min(side - 1, static_cast<size_t>(p.x * side));
+    size_t cy = std::min(side - 1, static_cast<size_t>(p.y * side));
+    return cy * side + cx;
+  };
+  std::vector<size_t> cellStart(side * side + 1, 0);
+  for (const Point &p : graph.coordinates)
+    cellStart[cellOf(p) + 1]++;
+  for (size_t c = 0; c < side * side; ++c)
+    cellStart[c + 1] += cellStart[c];
+  std::vector<size_t> position(cellStart.begin(), cellStart.end() - 1);
+  std::vector<unsigned> cells(vertices);
+  for (unsigned i = 0; i < vertices; ++i)
+    cells[position[cellOf(graph.coordinates[i])]++] = i;
+
+  for (unsigned u = 0; u < vertices; ++u) {
+    const Point &p = graph.coordinates[u];
+    size_t cell = cellOf(p);
+    size_t cx = cell % side, cy = cell / side;
+    for (size_t y = (cy ? cy - 1 : 0); y <= std::min(side - 1, cy + 1); ++y) {
+      for (size_t x = (cx ? cx - 1 : 0); x <= std::min(side - 1, cx + 1);
+           ++x) {
+        size_t c = y * side + x;
+        for (size_t i = cellStart[c]; i < cellStart[c + 1]; ++i) {
+          unsigned v = cells[i];
+          if (v <= u)
+            continue;
+          double dx = p.x - graph.coordinates[v].x;
+          double dy = p.y - graph.coordinates[v].y;
+          double length = std::sqrt(dx * dx + dy * dy);
+          if (length < radius) {
+            unsigned weight = static_cast<unsigned>(std::ceil(length * scale));
+            addUndirectedEdge(graph, u, v, std::max(1u, weight));
+          }
+        }
+      }
+    }
+  }
+  return graph;
+}
+
+/**
+ * Generates road-like grid graph
+ * vertex (x, y) has ID y * width + x and is connected to its 4 neighbours,
+ * every edge is left out with probability @dropProbability
+ * @param width number of columns
+ * @param height number of rows
+ * @param max maximum weight of edges (at least 1)
+ * @param dropProbability a number from 0 to 1
+ * @param seed seed of the random generator
+ * @return generated graph with coordinates
+ * @throws std::invalid_argument if max == 0
+ */
+inline GeneratedGraph generateGrid(size_t width, size_t height, unsigned max,
+                                   float dropProbability, unsigned seed) {
+  checkMaxWeight(max);
+  std::mt19937 generator(seed);
+  GeneratedGraph graph;
+  graph.vertices = width * height;
+  graph.coordinates.reserve(graph.vertices);
+  graph.edges.reserve(4 * graph.vertices);
+
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      graph.coordinates.push_back(
+          Point{static_cast<double>(x), static_cast<double>(y)});
+      unsigned u = static_cast<unsigned>(y * width + x);
+      if (x + 1 < width && generator() % 1000 >= dropProbability * 1000)
+        addUndirectedEdge(graph, u, u + 1, (generator() % max) + 1);
+      if (y + 1 < height && generator() % 1000 >= dropProbability * 1000)
+        addUndirectedEdge(graph, u, static_cast<unsigned>(u + width),
+                          (generator() % max) + 1);
+    }
+  }
+  return graph;
+}
+
+/**
+ * Generates power-law graph using the R-MAT model
+ * every edge picks its quadrant of the adjacency matrix recursively with
+ * probabilities a, b, c and 1 - a - b - c (self-loops are redrawn)
+ * @param scale the graph has 2^scale vertices (from 1 to 31)
+ * @param edges number of undirected edges
+ * @param max maximum weight of edges (at least 1)
+ * @param seed seed of the random generator
+ * @param a probability of the top left quadrant
+ * @param b probability of the top right quadrant
+ * @param c probability of the bottom left quadrant
+ * @return generated graph
+ * @throws std::invalid_argument if scale or max is out of range
+ */
+inline GeneratedGraph generateRMat(unsigned scale, size_t edges, unsigned max,
+                                   unsigned seed, double a = 0.57,
+                                   double b = 0.19, double c = 0.19) {
+  // scale 0 has a single vertex and every edge would be a redrawn self-loop,
+  // IDs of 2^32 and more vertices do not fit into unsigned
+  if (scale == 0 || scale >= 32)
+    throw std::invalid_argument("R-MAT scale must be from 1 to 31!");
+  checkMaxWeight(max);
+  std::mt19937 generator(seed);
+  GeneratedGraph graph;
+  graph.vertices = size_t(1) << scale;
+  graph.edges.reserve(2 * edges);
+
+  for (size_t i = 0; i < edges; ++i) {
+    unsigned u, v;
+    do {
+      u = 0;
+      v = 0;
+      for (unsigned bit = 0; bit < scale; ++bit) {
+        double r = generator() / 4294967296.0;
+        u <<= 1;
+        v <<= 1;
+        if (r >= a + b + c) {
+          u |= 1;
+          v |= 1;
+        } else if (r >= a + b) {
+          u |= 1;
+        } else if (r >= a) {
+          v |= 1;
+        }
+      }
+    } while (u == v);
+    addUndirectedEdge(graph, u, v, (generator() % max) + 1);
+  }
+  return graph;
+}
+
+#endif // FIBHEAP_GRAPHGENERATORS_HPP
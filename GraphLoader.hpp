@@ -0,0 +1,334 @@
+#ifndef FIBHEAP_GRAPHLOADER_HPP
+#define FIBHEAP_GRAPHLOADER_HPP
+
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Read-only memory mapping of a whole file
+ */
+class MappedFile {
+public:
+  /**
+   * maps file into memory
+   * may throw exceptions (if the file cannot be opened or mapped)
+   * @param path path to the file
+   * @param sequential hints the kernel the file is read front to back
+   */
+  explicit MappedFile(const std::string &path, bool sequential = true)
+      : m_data(nullptr), m_size(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("Cannot open file " + path + "!");
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Cannot read size of file " + path + "!");
+    }
+    m_size = static_cast<size_t>(info.st_size);
+
+    if (m_size > 0) {
+      void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Cannot map file " + path + "!");
+      }
+      m_data = static_cast<const char *>(data);
+      if (sequential)
+        ::madvise(data, m_size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile() {
+    if (m_data)
+      ::munmap(const_cast<char *>(m_data), m_size);
+  }
+
+  const char *data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  const char *m_data;
+  size_t m_size;
+};
+
+/**
+ * Parser of text graph formats working on a part of a mapped file
+ */
+class GraphTextParser {
+public:
+  GraphTextParser(const char *begin, const char *end)
+      : m_current(begin), m_end(end) {}
+
+  bool atEnd() const { return m_current >= m_end; }
+
+  char peek() const { return *m_current; }
+
+  /**
+   * skips the rest of the current line including '\n'
+   */
+  void skipLine() {
+    const void *newline = memchr(m_current, '\n', m_end - m_current);
+    m_current = newline ? static_cast<const char *>(newline) + 1 : m_end;
+  }
+
+  /**
+   * skips spaces and tabs
+   */
+  void skipBlanks() {
+    while (m_current < m_end && (*m_current == ' ' || *m_current == '\t' ||
+                                 *m_current == '\r'))
+      ++m_current;
+  }
+
+  /**
+   * skips a word (non-blank characters)
+   */
+  void skipWord() {
+    while (m_current < m_end && *m_current != ' ' && *m_current != '\t' &&
+           *m_current != '\n')
+      ++m_current;
+  }
+
+  /**
+   * skips blanks and checks whether a number follows
+   */
+  bool atNumber() {
+    skipBlanks();
+    return m_current < m_end && *m_current >= '0' && *m_current <= '9';
+  }
+
+  /**
+   * parses unsigned decimal number preceded by blanks
+   * @param value parsed number
+   * @param limit highest accepted value
+   * @return false if there is no number or it is greater than @limit
+   */
+  bool parseUnsigned(unsigned long long &value,
+                     unsigned long long limit = ULLONG_MAX) {
+    if (!atNumber())
+      return false;
+    value = 0;
+    while (m_current < m_end && *m_current >= '0' && *m_current <= '9') {
+      unsigned digit = static_cast<unsigned>(*m_current - '0');
+      if (value > (limit - digit) / 10)
+        return false;
+      value = value * 10 + digit;
+      ++m_current;
+    }
+    return true;
+  }
+
+  /**
+   * moves the beginning of a chunk to the beginning of the next line
+   * (unless it is the beginning of the whole file)
+   */
+  static const char *alignToLine(const char *data, const char *position,
+                                 const char *end) {
+    if (position == data)
+      return position;
+    const void *newline = memchr(position - 1, '\n', end - position + 1);
+    return newline ? static_cast<const char *>(newline) + 1 : end;
+  }
+
+private:
+  const char *m_current;
+  const char *m_end;
+};
+
+/**
+ * builds CSR graph from edge lists parsed by several threads
+ * edges keep the order of the file
+ * may throw exceptions (for edges with vertices out of range)
+ * @param vertices number of vertices
+ * @param parts edges parsed by every thread in the order of the file
+ * @return built graph
+ */
+inline CsrGraph
+csrFromEdgeParts(size_t vertices,
+                 const std::vector<std::vector<CsrGraph::Edge>> &parts) {
+  std::vector<uint64_t> offsets(vertices + 1, 0);
+  size_t edges = 0;
+  for (const auto &part : parts) {
+    for (const CsrGraph::Edge &edge : part) {
+      if (edge.from >= vertices || edge.to >= vertices)
+        throw std::runtime_error("Edge vertex out of range!");
+      offsets[edge.from + 1]++;
+    }
+    edges += part.size();
+  }
+  for (size_t u = 0; u < vertices; ++u)
+    offsets[u + 1] += offsets[u];
+
+  std::vector<uint64_t> position(offsets.begin(), offsets.end() - 1);
+  std::vector<unsigned> targets(edges), weights(edges);
+  for (const auto &part : parts) {
+    for (const CsrGraph::Edge &edge : part) {
+      uint64_t e = position[edge.from]++;
+      targets[e] = edge.to;
+      weights[e] = edge.weight;
+    }
+  }
+  return CsrGraph(std::move(offsets), std::move(targets), std::move(weights));
+}
+
+/**
+ * Loads graph in DIMACS shortest path format (.gr)
+ * "p sp <vertices> <arcs>" line gives the size, every "a <from> <to>
+ * <weight>" line is one directed edge (vertices are numbered from 1),
+ * lines starting with 'c' are comments, weights have to be lower than MY_MAX
+ * the file is mapped into memory and parsed by several threads
+ * may throw exceptions (for unreadable or malformed files)
+ * @param path path to the file
+ * @param threads number of parsing threads, 0 means hardware concurrency
+ * @return loaded graph
+ */
+inline CsrGraph loadDimacs(const std::string &path, unsigned threads = 0) {
+  MappedFile file(path);
+  ThreadPool pool(threads);
+  const char *data = file.data();
+  const char *end = data + file.size();
+  const size_t chunk = (file.size() + pool.size() - 1) / pool.size();
+
+  std::vector<std::vector<CsrGraph::Edge>> parts(pool.size());
+  std::vector<unsigned long long> declared(pool.size(), 0);
+
+  pool.run([&](unsigned worker) {
+    const char *begin = data + std::min(file.size(), worker * chunk);
+    const char *stop = data + std::min(file.size(), (worker + 1) * chunk);
+    begin = GraphTextParser::alignToLine(data, begin, end);
+    stop = GraphTextParser::alignToLine(data, stop, end);
+
+    GraphTextParser parser(begin, stop);
+    std::vector<CsrGraph::Edge> &edges = parts[worker];
+    unsigned long long from, to, weight, count;
+    while (!parser.atEnd()) {
+      char type = parser.peek();
+      if (type == 'a') {
+        parser.skipWord();
+        if (!parser.parseUnsigned(from, UINT_MAX) ||
+            !parser.parseUnsigned(to, UINT_MAX) ||
+            !parser.parseUnsigned(weight, MY_MAX - 1) || from == 0 || to == 0)
+          throw std::runtime_error("Malformed arc in " + path + "!");
+        edges.push_back(CsrGraph::Edge{static_cast<unsigned>(from - 1),
+                                       static_cast<unsigned>(to - 1),
+                                       static_cast<unsigned>(weight)});
+      } else if (type == 'p') {
+        parser.skipWord();
+        parser.skipBlanks();
+        parser.skipWord();
+        if (!parser.parseUnsigned(declared[worker], UINT_MAX) ||
+            !parser.parseUnsigned(count))
+          throw std::runtime_error("Malformed problem line in " + path + "!");
+        // the declared count is not trusted beyond what the chunk can hold
+        // (the shortest arc line "a 1 2 0\n" has 8 characters)
+        edges.reserve(std::min<unsigned long long>(count / pool.size(),
+                                                   chunk / 8));
+      }
+      parser.skipLine();
+    }
+  });
+
+  unsigned long long vertices =
+      *std::max_element(declared.begin(), declared.end());
+  if (vertices == 0)
+    throw std::runtime_error("Missing problem line in " + path + "!");
+  return csrFromEdgeParts(vertices, parts);
+}
+
+/**
+ * Loads graph from a text edge list
+ * every line "<from> <to> [weight]" is one directed edge (vertices are
+ * numbered from 0, default weight is 1, weights have to be lower than
+ * MY_MAX), lines starting with '#' or '%' are comments, number of vertices
+ * is the highest ID + 1
+ * may throw exceptions (for unreadable or malformed files)
+ * @param path path to the file
+ * @param threads number of parsing threads, 0 means hardware concurrency
+ * @return loaded graph
+ */
+inline CsrGraph loadEdgeList(const std::string &path, unsigned threads = 0) {
+  MappedFile file(path);
+  ThreadPool pool(threads);
+  const char *data = file.data();
+  const char *end = data + file.size();
+  const size_t chunk = (file.size() + pool.size() - 1) / pool.size();
+
+  std::vector<std::vector<CsrGraph::Edge>> parts(pool.size());
+  std::vector<unsigned long long> highest(pool.size(), 0);
+
+  pool.run([&](unsigned worker) {
+    const char *begin = data + std::min(file.size(), worker * chunk);
+    const char *stop = data + std::min(file.size(), (worker + 1) * chunk);
+    begin = GraphTextParser::alignToLine(data, begin, end);
+    stop = GraphTextParser::alignToLine(data, stop, end);
+
+    GraphTextParser parser(begin, stop);
+    std::vector<CsrGraph::Edge> &edges = parts[worker];
+    unsigned long long from, to, weight;
+    while (!parser.atEnd()) {
+      parser.skipBlanks();
+      if (parser.atEnd())
+        break;
+      char type = parser.peek();
+      if (type != '#' && type != '%' && type != '\n') {
+        // the highest ID + 1 has to fit the number of vertices
+        if (!parser.parseUnsigned(from, UINT_MAX - 1) ||
+            !parser.parseUnsigned(to, UINT_MAX - 1))
+          throw std::runtime_error("Malformed edge in " + path + "!");
+        weight = 1;
+        if (parser.atNumber() && !parser.parseUnsigned(weight, MY_MAX - 1))
+          throw std::runtime_error("Malformed edge in " + path + "!");
+        edges.push_back(CsrGraph::Edge{static_cast<unsigned>(from),
+                                       static_cast<unsigned>(to),
+                                       static_cast<unsigned>(weight)});
+        highest[worker] = std::max(highest[worker], std::max(from, to) + 1);
+      }
+      parser.skipLine();
+    }
+  });
+
+  return csrFromEdgeParts(*std::max_element(highest.begin(), highest.end()),
+                          parts);
+}
+
+/**
+ * Saves graph in DIMACS shortest path format
+ * may throw exceptions (if the file cannot be written)
+ * @param path path to the file
+ * @param graph graph to save
+ */
+inline void saveDimacs(const std::string &path, const CsrGraph &graph) {
+  std::ofstream file(path);
+  if (!file.is_open())
+    throw std::runtime_error("Cannot open file " + path + "!");
+
+  file << "c generated by pv264_project\n";
+  file << "p sp " << graph.size() << " " << graph.edgeCount() << "\n";
+  for (size_t u = 0; u < graph.size(); ++u) {
+    for (uint64_t e = graph.offsets()[u]; e < graph.offsets()[u + 1]; ++e) {
+      file << "a " << u + 1 << " " << graph.targets()[e] + 1 << " "
+           << graph.weights()[e] << "\n";
+    }
+  }
+  if (!file)
+    throw std::runtime_error("Cannot write file " + path + "!");
+}
+
+#endif // FIBHEAP_GRAPHLOADER_HPP
@@ -0,0 +1,160 @@
+#ifndef FIBHEAP_GRAPHSNAPSHOT_HPP
+#define FIBHEAP_GRAPHSNAPSHOT_HPP
+
+#include "Graph.hpp"
+#include "GraphLoader.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Header of the binary CSR graph snapshot
+ * the file consists of this header followed by offsets, targets and weights
+ * arrays, every array starts at a multiple of SNAPSHOT_ALIGNMENT, all
+ * numbers are stored in the byte order of the machine which wrote them
+ */
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t vertices;
+  uint64_t edges;
+  uint64_t offsetsPosition;
+  uint64_t targetsPosition;
+  uint64_t weightsPosition;
+  uint64_t fileSize;
+};
+
+const char SNAPSHOT_MAGIC[8] = {'F', 'I', 'B', 'C', 'S', 'R', '\0', '\0'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+const uint64_t SNAPSHOT_ALIGNMENT = 4096;
+
+/**
+ * rounds position up to a multiple of SNAPSHOT_ALIGNMENT
+ */
+inline uint64_t alignSnapshotPosition(uint64_t position) {
+  return (position + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT *
+         SNAPSHOT_ALIGNMENT;
+}
+
+/**
+ * checks that an array fits into the snapshot without overflowing
+ * @param position position of the array in the file
+ * @param count number of elements of the array
+ * @param elementSize size of one element
+ * @param fileSize size of the whole file
+ * @return true if the array ends within the file
+ */
+inline bool fitsSnapshot(uint64_t position, uint64_t count,
+                         uint64_t elementSize, uint64_t fileSize) {
+  return position <= fileSize && count <= (fileSize - position) / elementSize;
+}
+
+/**
+ * Saves graph as binary snapshot
+ * may throw exceptions (if the file cannot be written)
+ * @param path path to the file
+ * @param graph graph to save
+ */
+inline void saveSnapshot(const std::string &path, const CsrGraph &graph) {
+  SnapshotHeader header;
+  std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = SNAPSHOT_VERSION;
+  header.byteOrder = SNAPSHOT_BYTE_ORDER;
+  header.vertices = graph.size();
+  header.edges = graph.edgeCount();
+  header.offsetsPosition = alignSnapshotPosition(sizeof(SnapshotHeader));
+  header.targetsPosition = alignSnapshotPosition(
+      header.offsetsPosition + (header.vertices + 1) * sizeof(uint64_t));
+  header.weightsPosition = alignSnapshotPosition(
+      header.targetsPosition + header.edges * sizeof(unsigned));
+  header.fileSize = header.weightsPosition + header.edges * sizeof(unsigned);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+    throw std::runtime_error("Cannot open file " + path + "!");
+
+  auto writeAt = [&](uint64_t position, const void *data, uint64_t size) {
+    static const char padding[SNAPSHOT_ALIGNMENT] = {};
+    uint64_t current = static_cast<uint64_t>(file.tellp());
+    file.write(padding, static_cast<std::streamsize>(position - current));
+    file.write(static_cast<const char *>(data),
+               static_cast<std::streamsize>(size));
+  };
+  writeAt(0, &header, sizeof(header));
+  writeAt(header.offsetsPosition, graph.offsets(),
+          (header.vertices + 1) * sizeof(uint64_t));
+  writeAt(header.targetsPosition, graph.targets(),
+          header.edges * sizeof(unsigned));
+  writeAt(header.weightsPosition, graph.weights(),
+          header.edges * sizeof(unsigned));
+
+  if (!file)
+    throw std::runtime_error("Cannot write file " + path + "!");
+}
+
+/**
+ * Maps binary snapshot into memory and uses it as read-only graph
+ * the arrays are used directly from the mapping (no deserialization),
+ * so only the header and the array sizes are checked
+ * may throw exceptions (for unreadable, incompatible or truncated files)
+ * @param path path to the file
+ * @return graph backed by the mapped file
+ */
+inline CsrGraph loadSnapshot(const std::string &path) {
+  auto file = std::make_shared<MappedFile>(path, false);
+  if (file->size() < sizeof(SnapshotHeader))
+    throw std::runtime_error("Truncated snapshot " + path + "!");
+
+  SnapshotHeader header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0)
+    throw std::runtime_error("File " + path + " is not a graph snapshot!");
+  if (header.version != SNAPSHOT_VERSION)
+    throw std::runtime_error("Unsupported snapshot version in " + path + "!");
+  if (header.byteOrder != SNAPSHOT_BYTE_ORDER)
+    throw std::runtime_error("Snapshot " + path +
+                             " has different byte order!");
+  if (header.fileSize != file->size() ||
+      header.offsetsPosition % SNAPSHOT_ALIGNMENT ||
+      header.targetsPosition % SNAPSHOT_ALIGNMENT ||
+      header.weightsPosition % SNAPSHOT_ALIGNMENT ||
+      // vertices + 1 offsets (fileSize is at least the size of the header)
+      !fitsSnapshot(header.offsetsPosition, header.vertices, sizeof(uint64_t),
+                    header.fileSize - sizeof(uint64_t)) ||
+      !fitsSnapshot(header.targetsPosition, header.edges, sizeof(unsigned),
+                    header.fileSize) ||
+      !fitsSnapshot(header.weightsPosition, header.edges, sizeof(unsigned),
+                    header.fileSize))
+    throw std::runtime_error("Corrupted snapshot " + path + "!");
+
+  const char *data = file->data();
+  const uint64_t *offsets =
+      reinterpret_cast<const uint64_t *>(data + header.offsetsPosition);
+  if (offsets[header.vertices] != header.edges)
+    throw std::runtime_error("Corrupted snapshot " + path + "!");
+
+  return CsrGraph::external(
+      file, header.vertices, header.edges, offsets,
+      reinterpret_cast<const unsigned *>(data + header.targetsPosition),
+      reinterpret_cast<const unsigned *>(data + header.weightsPosition));
+}
+
+/**
+ * Converts DIMACS graph to binary snapshot
+ * may throw exceptions (for unreadable or malformed files)
+ * @param dimacsPath path to the .gr file
+ * @param snapshotPath path to the snapshot to write
+ * @param threads number of parsing threads, 0 means hardware concurrency
+ */
+inline void convertDimacsToSnapshot(const std::string &dimacsPath,
+                                    const std::string &snapshotPath,
+                                    unsigned threads = 0) {
+  saveSnapshot(snapshotPath, loadDimacs(dimacsPath, threads));
+}
+
+#endif // FIBHEAP_GRAPHSNAPSHOT_HPP
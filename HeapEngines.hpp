@@ -0,0 +1,207 @@
+#ifndef FIBHEAP_HEAPENGINES_HPP
+#define FIBHEAP_HEAPENGINES_HPP
+
+#include "FibHeap.hpp"
+#include <cstddef>
+#include <optional>
+#include <queue>
+#include <vector>
+
+/**
+ * Addressable min-priority queues of vertex IDs used by the graph algorithms
+ * every engine has the same interface, so the algorithms take the engine as a
+ * template parameter:
+ *   reset(size)      - empties the engine for vertices 0 .. size - 1
+ *   offer(v, key)    - inserts @v or lowers its key, returns true if the key
+ *                      of @v changed (false for worse keys and popped vertices)
+ *   empty(), top(), topKey(), pop()
+ *   erase(v)         - removes queued @v, it is handled as popped afterwards
+ *   merge(first, count, keys)
+ *                    - inserts unseen vertices first .. first + count - 1
+ *                      with keys[v] at once
+ *   decreases()      - number of successful key decreases since reset
+ * runWorkload (Workload.hpp) replays generated workloads and traces on them
+ */
+
+/**
+ * single entry of an engine, the lowest key (then the lowest ID) is the top
+ */
+template <typename Key> struct EngineEntry {
+  Key key;
+  unsigned id;
+};
+
+template <typename Key> struct cmpEngineEntry {
+  bool operator()(const EngineEntry<Key> &first,
+                  const EngineEntry<Key> &second) const {
+    return first.key == second.key ? first.id > second.id
+                                   : first.key > second.key;
+  }
+};
+
+/**
+ * engine built on FibHeap, lowers keys with increase_key
+ */
+template <typename Key> class FibHeapEngine {
+public:
+  using Entry = EngineEntry<Key>;
+  using Heap = FibHeap<Entry, cmpEngineEntry<Key>>;
+
+  FibHeapEngine() : m_handlers(), m_heap(), m_state(), m_decreases(0) {}
+
+  FibHeapEngine(const FibHeapEngine &) = delete;
+  FibHeapEngine &operator=(const FibHeapEngine &) = delete;
+
+  void reset(size_t size) {
+    if (!m_heap.empty())
+      m_heap = Heap();
+    m_handlers.clear();
+    m_handlers.resize(size);
+    m_state.assign(size, Unseen);
+    m_decreases = 0;
+  }
+
+  bool offer(unsigned v, Key key) {
+    if (m_state[v] == Unseen) {
+      m_state[v] = Queued;
+      m_handlers[v].emplace(m_heap.insert(Entry{key, v}));
+      return true;
+    }
+    if (m_state[v] == Popped || !(key < m_handlers[v]->value().key))
+      return false;
+    m_heap.increase_key(*m_handlers[v], Entry{key, v});
+    m_decreases++;
+    return true;
+  }
+
+  bool empty() const { return m_heap.empty(); }
+  unsigned top() const { return m_heap.top().id; }
+  Key topKey() const { return m_heap.top().key; }
+
+  void pop() {
+    m_state[m_heap.top().id] = Popped;
+    m_heap.extract_top();
+  }
+
+  void erase(unsigned v) {
+    m_state[v] = Popped;
+    m_heap.delete_value(*m_handlers[v]);
+  }
+
+  /**
+   * builds a heap of the new vertices and melds it with uniteWith
+   */
+  void merge(unsigned first, unsigned count, const Key *keys) {
+    Heap other;
+    for (unsigned v = first; v < first + count; ++v) {
+      m_state[v] = Queued;
+      m_handlers[v].emplace(other.insert(Entry{keys[v], v}));
+    }
+    m_heap.uniteWith(other);
+  }
+
+  size_t decreases() const { return m_decreases; }
+
+  FibHeapStats stats() const { return m_heap.stats(); }
+  void resetStats() { m_heap.resetStats(); }
+
+  /**
+   *
+   * @return bytes held by the heap and the tables of handlers and states
+   */
+  size_t memory_usage() const {
+    return m_heap.memory_usage().total() +
+           m_handlers.capacity() *
+               sizeof(std::optional<typename Heap::Handler>) +
+           m_state.capacity() * sizeof(State);
+  }
+
+private:
+  enum State : unsigned char { Unseen, Queued, Popped };
+
+  std::vector<std::optional<typename Heap::Handler>> m_handlers;
+  Heap m_heap;
+  std::vector<State> m_state;
+  size_t m_decreases;
+};
+
+/**
+ * engine built on std::priority_queue without decrease-key
+ * lowering a key pushes a new entry, erase only marks the vertex, outdated
+ * entries are skipped, so the top is always current
+ */
+template <typename Key> class LazyQueueEngine {
+public:
+  using Entry = EngineEntry<Key>;
+
+  LazyQueueEngine() : m_queue(), m_keys(), m_state(), m_decreases(0) {}
+
+  void reset(size_t size) {
+    m_queue = Queue();
+    m_keys.resize(size);
+    m_state.assign(size, Unseen);
+    m_decreases = 0;
+  }
+
+  bool offer(unsigned v, Key key) {
+    if (m_state[v] == Popped || (m_state[v] == Queued && !(key < m_keys[v])))
+      return false;
+    if (m_state[v] == Queued)
+      m_decreases++;
+    m_state[v] = Queued;
+    m_keys[v] = key;
+    m_queue.push(Entry{key, v});
+    return true;
+  }
+
+  bool empty() const { return m_queue.empty(); }
+  unsigned top() const { return m_queue.top().id; }
+  Key topKey() const { return m_queue.top().key; }
+
+  void pop() {
+    m_state[m_queue.top().id] = Popped;
+    m_queue.pop();
+    skipOutdated();
+  }
+
+  void erase(unsigned v) {
+    m_state[v] = Popped;
+    skipOutdated();
+  }
+
+  void merge(unsigned first, unsigned count, const Key *keys) {
+    for (unsigned v = first; v < first + count; ++v)
+      offer(v, keys[v]);
+  }
+
+  size_t decreases() const { return m_decreases; }
+
+  /**
+   * the queue is counted by its size (capacity of std::priority_queue is not
+   * accessible)
+   * @return bytes held by the queue and the tables of keys and states
+   */
+  size_t memory_usage() const {
+    return m_queue.size() * sizeof(Entry) + m_keys.capacity() * sizeof(Key) +
+           m_state.capacity() * sizeof(State);
+  }
+
+private:
+  enum State : unsigned char { Unseen, Queued, Popped };
+  using Queue =
+      std::priority_queue<Entry, std::vector<Entry>, cmpEngineEntry<Key>>;
+
+  // outdated entries have a higher key than the current one or were popped
+  void skipOutdated() {
+    while (!m_queue.empty() && (m_state[m_queue.top().id] == Popped ||
+                                m_keys[m_queue.top().id] < m_queue.top().key))
+      m_queue.pop();
+  }
+
+  Queue m_queue;
+  std::vector<Key> m_keys;
+  std::vector<State> m_state;
+  size_t m_decreases;
+};
+
+#endif // FIBHEAP_HEAPENGINES_HPP
@@ -0,0 +1,210 @@
+#ifndef FIBHEAP_LATENCYHISTOGRAM_HPP
+#define FIBHEAP_LATENCYHISTOGRAM_HPP
+
+#include "FibHeap.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+/**
+ * HDR-style histogram of latencies in nanoseconds
+ * values below 2^SubBits are counted exactly, larger values fall into
+ * logarithmic ranges split into 2^(SubBits - 1) linear buckets each, so the
+ * relative error of a reported value is below 2^(1 - SubBits) (< 1 %)
+ * for the whole 64-bit range and the histogram has a fixed size
+ */
+class LatencyHistogram {
+public:
+  static const unsigned SubBits = 8;
+
+  LatencyHistogram()
+      : m_counts(bucketCount(), 0), m_count(0), m_sum(0), m_min(UINT64_MAX),
+        m_max(0) {}
+
+  /**
+   * adds one value
+   * @param nanoseconds measured latency
+   */
+  void record(uint64_t nanoseconds) {
+    m_counts[index(nanoseconds)]++;
+    m_count++;
+    m_sum += nanoseconds;
+    m_min = std::min(m_min, nanoseconds);
+    m_max = std::max(m_max, nanoseconds);
+  }
+
+  /**
+   * runs @operation and records its latency
+   * @param operation timed function
+   * @return result of @operation
+   */
+  template <typename F> auto timed(F &&operation) -> decltype(operation()) {
+    auto start = std::chrono::steady_clock::now();
+    if constexpr (std::is_void_v<decltype(operation())>) {
+      operation();
+      record(elapsed(start));
+    } else {
+      auto result = operation();
+      record(elapsed(start));
+      return result;
+    }
+  }
+
+  /**
+   * adds all values of @other
+   */
+  void merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < m_counts.size(); ++i)
+      m_counts[i] += other.m_counts[i];
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+  }
+
+  void clear() {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = m_sum = m_max = 0;
+    m_min = UINT64_MAX;
+  }
+
+  /**
+   *
+   * @return the value below or at which @percentile % of values lie
+   * (the highest value of its bucket, at most max), 0 for empty histogram
+   */
+  uint64_t percentile(double percentile) const {
+    if (m_count == 0)
+      return 0;
+    uint64_t rank = static_cast<uint64_t>(percentile / 100 * m_count + 0.5);
+    rank = std::min(m_count, std::max<uint64_t>(1, rank));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_counts.size(); ++i) {
+      seen += m_counts[i];
+      if (seen >= rank)
+        return std::min(m_max, highestValue(i));
+    }
+    return m_max;
+  }
+
+  uint64_t count() const { return m_count; }
+  uint64_t min() const { return m_count ? m_min : 0; }
+  uint64_t max() const { return m_max; }
+  double mean() const {
+    return m_count ? static_cast<double>(m_sum) / m_count : 0;
+  }
+
+  /**
+   *
+   * @return number of buckets covering the whole 64-bit range
+   */
+  static size_t bucketCount() {
+    return (size_t(1) << SubBits) + (64 - SubBits) * (size_t(1) << (SubBits - 1));
+  }
+
+  /**
+   *
+   * @return index of the bucket counting @value
+   */
+  static size_t index(uint64_t value) {
+    const uint64_t exact = uint64_t(1) << SubBits;
+    if (value < exact)
+      return static_cast<size_t>(value);
+    unsigned shift = 63 - static_cast<unsigned>(__builtin_clzll(value)) -
+                     (SubBits - 1);
+    uint64_t mantissa = value >> shift; // in [exact / 2, exact)
+    return static_cast<size_t>(exact + (shift - 1) * (exact / 2) +
+                               (mantissa - exact / 2));
+  }
+
+  /**
+   *
+   * @return the highest value counted by the bucket @index
+   */
+  static uint64_t highestValue(size_t index) {
+    const uint64_t exact = uint64_t(1) << SubBits;
+    if (index < exact)
+      return index;
+    unsigned shift = static_cast<unsigned>((index - exact) / (exact / 2)) + 1;
+    uint64_t mantissa = exact / 2 + (index - exact) % (exact / 2);
+    // (mantissa + 1) << shift would wrap for the top bucket
+    return (mantissa << shift) + ((uint64_t(1) << shift) - 1);
+  }
+
+private:
+  static uint64_t
+  elapsed(std::chrono::time_point<std::chrono::steady_clock> start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+  }
+
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint64_t m_min;
+  uint64_t m_max;
+};
+
+/**
+ * wrapper of FibHeap recording latency of every insert, extract_top,
+ * increase_key and delete_value into a separate histogram
+ * the clock is read twice per operation (tens of nanoseconds),
+ * which is included in the recorded values
+ */
+template <typename Value, typename Compare = std::less<Value>>
+class TimedFibHeap {
+public:
+  using Heap = FibHeap<Value, Compare>;
+  using Handler = typename Heap::Handler;
+
+  explicit TimedFibHeap(Heap &heap)
+      : m_heap(heap), m_inserts(), m_extracts(), m_increases(), m_deletes() {}
+
+  template <typename T = Value> Handler insert(T &&value) {
+    return m_inserts.timed(
+        [&] { return m_heap.insert(std::forward<T>(value)); });
+  }
+
+  void extract_top() {
+    m_extracts.timed([&] { m_heap.extract_top(); });
+  }
+
+  void increase_key(const Handler &h, const Value &new_value) {
+    m_increases.timed([&] { m_heap.increase_key(h, new_value); });
+  }
+
+  void delete_value(Handler &h) {
+    m_deletes.timed([&] { m_heap.delete_value(h); });
+  }
+
+  /**
+   * clears all histograms, e.g. after a warmup
+   */
+  void clear() {
+    m_inserts.clear();
+    m_extracts.clear();
+    m_increases.clear();
+    m_deletes.clear();
+  }
+
+  Heap &heap() { return m_heap; }
+
+  const LatencyHistogram &inserts() const { return m_inserts; }
+  const LatencyHistogram &extracts() const { return m_extracts; }
+  const LatencyHistogram &increases() const { return m_increases; }
+  const LatencyHistogram &deletes() const { return m_deletes; }
+
+private:
+  Heap &m_heap;
+  LatencyHistogram m_inserts;
+  LatencyHistogram m_extracts;
+  LatencyHistogram m_increases;
+  LatencyHistogram m_deletes;
+};
+
+#endif // FIBHEAP_LATENCYHISTOGRAM_HPP
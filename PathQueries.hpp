@@ -0,0 +1,581 @@
+#ifndef FIBHEAP_PATHQUERIES_HPP
+#define FIBHEAP_PATHQUERIES_HPP
+
+#include "FibHeap.hpp"
+#include "Graph.hpp"
+#include "GraphGenerators.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Result of a point-to-point query
+ * distance is MY_MAX if the target is unreachable
+ * settled counts vertices extracted from the heaps
+ */
+struct PathQueryResult {
+  unsigned distance;
+  size_t settled;
+};
+
+/**
+ * Bidirectional Dijkstra for a single pair of vertices
+ * forward search runs on @graph from @fromID, backward search runs on
+ * @reversed (graph.reversed()) from @toID, each with its own Fibonacci heap;
+ * the search with the lower top is advanced and both stop once the sum of
+ * the tops reaches the best path found so far
+ * @param graph graph to search
+ * @param reversed the same graph with reversed edges
+ * @param fromID source vertex
+ * @param toID target vertex
+ * @return distance from @fromID to @toID
+ */
+inline PathQueryResult shortestPathBidirectional(const CsrGraph &graph,
+                                                 const CsrGraph &reversed,
+                                                 unsigned fromID,
+                                                 unsigned toID) {
+  using Heap = FibHeap<Vertex, cmpVertex>;
+  const size_t size = graph.size();
+
+  std::vector<std::optional<Heap::Handler>> handlers[2];
+  std::vector<unsigned> distances[2];
+  const CsrGraph *graphs[2] = {&graph, &reversed};
+  Heap heaps[2];
+
+  PathQueryResult result{MY_MAX, 0};
+  if (fromID == toID) {
+    result.distance = 0;
+    return result;
+  }
+
+  for (unsigned side = 0; side < 2; ++side) {
+    handlers[side].resize(size);
+    distances[side].assign(size, MY_MAX);
+  }
+  distances[0][fromID] = 0;
+  distances[1][toID] = 0;
+  handlers[0][fromID].emplace(heaps[0].insert(Vertex(fromID, 0)));
+  handlers[1][toID].emplace(heaps[1].insert(Vertex(toID, 0)));
+
+  while (!heaps[0].empty() && !heaps[1].empty()) {
+    if (heaps[0].top().dist + heaps[1].top().dist >= result.distance)
+      break;
+
+    unsigned side = heaps[0].top().dist <= heaps[1].top().dist ? 0 : 1;
+    Heap &heap = heaps[side];
+    std::vector<unsigned> &distance = distances[side];
+    const std::vector<unsigned> &other = distances[1 - side];
+    const CsrGraph &g = *graphs[side];
+
+    unsigned u = heap.top().ID;
+    unsigned d = heap.top().dist;
+    heap.extract_top();
+    result.settled++;
+
+    for (uint64_t e = g.offsets()[u]; e < g.offsets()[u + 1]; ++e) {
+      unsigned v = g.targets()[e];
+      unsigned candidate = d + g.weights()[e];
+      if (candidate < distance[v]) {
+        std::optional<Heap::Handler> &handler = handlers[side][v];
+        if (!handler) {
+          handler.emplace(heap.insert(Vertex(v, candidate)));
+        } else if (handler->isValid()) {
+          heap.increase_key(*handler, Vertex(v, candidate));
+        } else {
+          continue;
+        }
+        distance[v] = candidate;
+      }
+      if (other[v] != MY_MAX && distance[v] + other[v] < result.distance)
+        result.distance = distance[v] + other[v];
+    }
+  }
+  return result;
+}
+
+/**
+ * Key of a vertex in A* search
+ * g - distance from the source, h - estimate of the distance to the target
+ */
+struct AStarVertex {
+  AStarVertex(unsigned id, unsigned distance, unsigned estimate)
+      : g(distance), h(estimate), ID(id) {}
+
+  unsigned g;
+  unsigned h;
+  unsigned ID;
+};
+
+/**
+ * Structure for AStarVertex comparison
+ * orders by g + h, ties prefer vertices closer to the target (higher g)
+ */
+struct cmpAStarVertex {
+  bool operator()(const AStarVertex &first, const AStarVertex &second) {
+    unsigned f1 = first.g + first.h, f2 = second.g + second.h;
+    if (f1 != f2)
+      return f1 > f2;
+    return first.g == second.g ? first.ID > second.ID : first.g < second.g;
+  }
+};
+
+/**
+ * Heuristic without any knowledge (A* becomes Dijkstra)
+ */
+struct ZeroHeuristic {
+  unsigned operator()(unsigned) const { return 0; }
+};
+
+/**
+ * Straight line distance to the target
+ * admissible for graphs where every edge weighs at least its length
+ * multiplied by @scale (e.g. generateGeometric with the same scale)
+ */
+struct EuclideanHeuristic {
+  EuclideanHeuristic(const std::vector<Point> &coordinates, unsigned target,
+                     double scale)
+      : m_coordinates(&coordinates), m_target(coordinates.at(target)),
+        m_scale(scale) {}
+
+  unsigned operator()(unsigned v) const {
+    double dx = (*m_coordinates)[v].x - m_target.x;
+    double dy = (*m_coordinates)[v].y - m_target.y;
+    // rounded down with a margin for floating point errors
+    return static_cast<unsigned>(std::sqrt(dx * dx + dy * dy) * m_scale *
+                                 (1 - 1e-9));
+  }
+
+private:
+  const std::vector<Point> *m_coordinates;
+  Point m_target;
+  double m_scale;
+};
+
+/**
+ * Manhattan distance to the target
+ * admissible for grid graphs where a unit step weighs at least @scale
+ * (e.g. generateGrid with scale 1)
+ */
+struct ManhattanHeuristic {
+  ManhattanHeuristic(const std::vector<Point> &coordinates, unsigned target,
+                     double scale)
+      : m_coordinates(&coordinates), m_target(coordinates.at(target)),
+        m_scale(scale) {}
+
+  unsigned operator()(unsigned v) const {
+    double dx = std::fabs((*m_coordinates)[v].x - m_target.x);
+    double dy = std::fabs((*m_coordinates)[v].y - m_target.y);
+    return static_cast<unsigned>((dx + dy) * m_scale * (1 - 1e-9));
+  }
+
+private:
+  const std::vector<Point> *m_coordinates;
+  Point m_target;
+  double m_scale;
+};
+
+/**
+ * Distances from and to a few landmark vertices, precomputed for ALT
+ * heuristic (A*, landmarks, triangle inequality)
+ */
+struct Landmarks {
+  /**
+   * computes distances for landmarks chosen by farthest point selection
+   * @param graph graph to search
+   * @param reversed the same graph with reversed edges
+   * @param count number of landmarks
+   * @param first first landmark
+   */
+  Landmarks(const CsrGraph &graph, const CsrGraph &reversed, unsigned count,
+            unsigned first = 0)
+      : ids(), from(), to() {
+    std::vector<unsigned> closest(graph.size(), MY_MAX);
+    unsigned next = first;
+    for (unsigned i = 0; i < count && i < graph.size(); ++i) {
+      ids.push_back(next);
+      from.push_back(graph.shortestPathPriorityQueue(next, false, false));
+      to.push_back(reversed.shortestPathPriorityQueue(next, false, false));
+
+      // next landmark is the reachable vertex farthest from all chosen ones
+      unsigned farthest = 0;
+      for (unsigned v = 0; v < graph.size(); ++v) {
+        closest[v] = std::min(closest[v], from.back()[v]);
+        if (closest[v] != MY_MAX && closest[v] > farthest) {
+          farthest = closest[v];
+          next = v;
+        }
+      }
+    }
+  }
+
+  std::vector<unsigned> ids;
+  // from[i][v] - distance from landmark i to v, to[i][v] - from v to i
+  std::vector<std::vector<unsigned>> from;
+  std::vector<std::vector<unsigned>> to;
+};
+
+/**
+ * ALT heuristic, lower bound from the triangle inequality with landmarks
+ */
+struct LandmarkHeuristic {
+  LandmarkHeuristic(const Landmarks &landmarks, unsigned target)
+      : m_landmarks(&landmarks), m_target(target) {}
+
+  unsigned operator()(unsigned v) const {
+    unsigned best = 0;
+    for (size_t i = 0; i < m_landmarks->ids.size(); ++i) {
+      const std::vector<unsigned> &from = m_landmarks->from[i];
+      const std::vector<unsigned> &to = m_landmarks->to[i];
+      if (from[m_target] != MY_MAX && from[v] != MY_MAX &&
+          from[m_target] > from[v])
+        best = std::max(best, from[m_target] - from[v]);
+      if (to[v] != MY_MAX && to[m_target] != MY_MAX && to[v] > to[m_target])
+        best = std::max(best, to[v] - to[m_target]);
+    }
+    return best;
+  }
+
+private:
+  const Landmarks *m_landmarks;
+  unsigned m_target;
+};
+
+/**
+ * A* search for a single pair of vertices with Fibonacci heap
+ * vertices are ordered by g + h, where h is given by @heuristic;
+ * the heuristic has to be consistent (all the heuristics above are)
+ * @param graph graph to search
+ * @param fromID source vertex
+ * @param toID target vertex
+ * @param heuristic functor returning lower bound of the distance from
+ * a vertex to @toID
+ * @return distance from @fromID to @toID
+ */
+template <typename Heuristic>
+PathQueryResult shortestPathAStar(const CsrGraph &graph, unsigned fromID,
+                                  unsigned toID, Heuristic heuristic) {
+  using Heap = FibHeap<AStarVertex, cmpAStarVertex>;
+
+  std::vector<std::optional<Heap::Handler>> handlers(graph.size());
+  std::vector<unsigned> distances(graph.size(), MY_MAX);
+  Heap heap;
+
+  PathQueryResult result{MY_MAX, 0};
+  distances[fromID] = 0;
+  handlers[fromID].emplace(
+      heap.insert(AStarVertex(fromID, 0, heuristic(fromID))));
+
+  while (!heap.empty()) {
+    AStarVertex top = heap.top();
+    heap.extract_top();
+    result.settled++;
+    if (top.ID == toID) {
+      result.distance = top.g;
+      break;
+    }
+
+    for (uint64_t e = graph.offsets()[top.ID]; e < graph.offsets()[top.ID + 1];
+         ++e) {
+      unsigned v = graph.targets()[e];
+      unsigned candidate = top.g + graph.weights()[e];
+      if (candidate >= distances[v])
+        continue;
+
+      std::optional<Heap::Handler> &handler = handlers[v];
+      if (!handler) {
+        handler.emplace(heap.insert(AStarVertex(v, candidate, heuristic(v))));
+      } else if (handler->isValid()) {
+        heap.increase_key(*handler,
+                          AStarVertex(v, candidate, handler->value().h));
+      } else {
+        continue;
+      }
+      distances[v] = candidate;
+    }
+  }
+  return result;
+}
+
+/**
+ * Conditions for stopping Dijkstra before the whole graph is settled
+ * the search stops as soon as any of the set conditions holds
+ */
+struct DijkstraOptions {
+  DijkstraOptions()
+      : targets(), targetCount(0), maxSettled(0), maxDistance(MY_MAX) {}
+
+  // stop after @targetCount of these vertices are settled
+  std::vector<unsigned> targets;
+  // 0 means all the targets
+  size_t targetCount;
+  // stop after this many vertices are settled, 0 means no limit
+  size_t maxSettled;
+  // stop when the closest unsettled vertex is farther than this
+  unsigned maxDistance;
+};
+
+/**
+ * Result of Dijkstra with early termination
+ * distances are exact for settled vertices and MY_MAX for the others,
+ * settled lists vertices in the order they were settled (by distance)
+ */
+struct DijkstraResult {
+  DijkstraResult() : distances(), settled(), complete(true) {}
+
+  std::vector<unsigned> distances;
+  std::vector<unsigned> settled;
+  // false if the search stopped before settling all reachable vertices
+  bool complete;
+};
+
+/**
+ * Reusable buffers for repeated Dijkstra queries on graphs of similar size
+ * every vertex remembers the number of the query which last touched it,
+ * so entries left by older queries count as unset and nothing has to be
+ * cleared between queries; vertices enter the heap only when reached
+ */
+class DijkstraWorkspace {
+public:
+  using Heap = FibHeap<Vertex, cmpVertex>;
+
+  DijkstraWorkspace()
+      : m_states(), m_handlers(), m_heap(), m_settled(), m_query(0),
+        m_complete(true) {}
+
+  DijkstraWorkspace(const DijkstraWorkspace &) = delete;
+  DijkstraWorkspace &operator=(const DijkstraWorkspace &) = delete;
+
+  /**
+   * runs Dijkstra from @fromID, results are valid until the next run
+   * @param graph graph to search
+   * @param fromID source vertex
+   * @param options stopping conditions
+   */
+  void run(const CsrGraph &graph, unsigned fromID,
+           const DijkstraOptions &options = DijkstraOptions()) {
+    run(graph, &fromID, &fromID + 1, options);
+  }
+
+  /**
+   * runs multi-source Dijkstra, all sources start with distance 0 in one heap
+   * so every vertex gets the distance to its nearest source
+   * @param graph graph to search
+   * @param sources source vertices
+   * @param options stopping conditions
+   */
+  void run(const CsrGraph &graph, const std::vector<unsigned> &sources,
+           const DijkstraOptions &options = DijkstraOptions()) {
+    run(graph, sources.data(), sources.data() + sources.size(), options);
+  }
+
+  /**
+   * runs multi-source Dijkstra from vertices in [@begin, @end)
+   * @param graph graph to search
+   * @param begin first source vertex
+   * @param end behind the last source vertex
+   * @param options stopping conditions
+   */
+  void run(const CsrGraph &graph, const unsigned *begin, const unsigned *end,
+           const DijkstraOptions &options = DijkstraOptions()) {
+    prepare(graph.size());
+
+    size_t remainingTargets = 0;
+    for (unsigned target : options.targets) {
+      State &state = m_states.at(target);
+      if (state.target != m_query) {
+        state.target = m_query;
+        remainingTargets++;
+      }
+    }
+    if (options.targetCount && options.targetCount < remainingTargets)
+      remainingTargets = options.targetCount;
+    const bool stopAtTargets = remainingTargets > 0;
+
+    for (const unsigned *source = begin; source != end; ++source) {
+      if (*source >= graph.size())
+        throw std::invalid_argument("Source vertex out of range!");
+      reach(*source, 0, *source);
+    }
+
+    while (!m_heap.empty()) {
+      if (m_heap.top().dist > options.maxDistance) {
+        m_complete = false;
+        break;
+      }
+
+      unsigned u = m_heap.top().ID;
+      unsigned d = m_heap.top().dist;
+      m_heap.extract_top();
+      m_states[u].settled = m_query;
+      m_settled.push_back(u);
+
+      for (uint64_t e = graph.offsets()[u]; e < graph.offsets()[u + 1]; ++e)
+        reach(graph.targets()[e], d + graph.weights()[e], m_states[u].source);
+
+      if ((stopAtTargets && m_states[u].target == m_query &&
+           --remainingTargets == 0) ||
+          (options.maxSettled && m_settled.size() >= options.maxSettled)) {
+        m_complete = m_heap.empty();
+        break;
+      }
+    }
+  }
+
+  /**
+   *
+   * @return distance of @v if it was settled by the last run, else MY_MAX
+   */
+  unsigned distance(unsigned v) const {
+    const State &state = m_states.at(v);
+    return state.settled == m_query ? state.distance : MY_MAX;
+  }
+
+  /**
+   *
+   * @return source nearest to @v if @v was settled by the last run,
+   * else MY_MAX
+   */
+  unsigned source(unsigned v) const {
+    const State &state = m_states.at(v);
+    return state.settled == m_query ? state.source : MY_MAX;
+  }
+
+  /**
+   *
+   * @return true if @v was settled by the last run
+   */
+  bool isSettled(unsigned v) const { return m_states.at(v).settled == m_query; }
+
+  /**
+   *
+   * @return vertices settled by the last run, in order of their distance
+   */
+  const std::vector<unsigned> &settled() const { return m_settled; }
+
+  /**
+   *
+   * @return false if the last run stopped before settling all reachable
+   * vertices
+   */
+  bool complete() const { return m_complete; }
+
+private:
+  /**
+   * per-vertex state, every field is valid only if its query number
+   * equals the current query
+   */
+  struct State {
+    unsigned reached;
+    unsigned settled;
+    unsigned target;
+    unsigned distance;
+    unsigned source;
+  };
+
+  /**
+   * starts new query, grows the buffers and drops the previous heap
+   * @param size number of vertices of the searched graph
+   */
+  void prepare(size_t size) {
+    if (m_states.size() < size) {
+      m_states.resize(size, State{0, 0, 0, MY_MAX, MY_MAX});
+      m_handlers.resize(size);
+    }
+    if (++m_query == 0) {
+      // query numbers wrapped around, old entries could look valid
+      std::fill(m_states.begin(), m_states.end(), State{0, 0, 0, MY_MAX, MY_MAX});
+      m_query = 1;
+    }
+    if (!m_heap.empty())
+      m_heap = Heap();
+    m_settled.clear();
+    m_complete = true;
+  }
+
+  /**
+   * updates tentative distance of @v (inserts it on first reach)
+   * @param v reached vertex
+   * @param distance length of the found path
+   * @param source source where the found path starts
+   */
+  void reach(unsigned v, unsigned distance, unsigned source) {
+    State &state = m_states[v];
+    if (state.reached != m_query) {
+      state.reached = m_query;
+      state.distance = distance;
+      state.source = source;
+      m_handlers[v].emplace(m_heap.insert(Vertex(v, distance)));
+    } else if (state.settled != m_query && distance < state.distance) {
+      state.distance = distance;
+      state.source = source;
+      m_heap.increase_key(*m_handlers[v], Vertex(v, distance));
+    }
+  }
+
+  std::vector<State> m_states;
+  std::vector<std::optional<Heap::Handler>> m_handlers;
+  Heap m_heap;
+  std::vector<unsigned> m_settled;
+  unsigned m_query;
+  bool m_complete;
+};
+
+/**
+ * Dijkstra with Fibonacci heap which stops early according to @options
+ * convenience wrapper running a temporary DijkstraWorkspace
+ * @param graph graph to search
+ * @param fromID source vertex
+ * @param options stopping conditions
+ * @return distances of settled vertices
+ */
+inline DijkstraResult shortestPathBounded(const CsrGraph &graph,
+                                          unsigned fromID,
+                                          const DijkstraOptions &options) {
+  DijkstraWorkspace workspace;
+  workspace.run(graph, fromID, options);
+
+  DijkstraResult result;
+  result.distances.assign(graph.size(), MY_MAX);
+  for (unsigned v : workspace.settled())
+    result.distances[v] = workspace.distance(v);
+  result.settled = workspace.settled();
+  result.complete = workspace.complete();
+  return result;
+}
+
+/**
+ * Computes many-to-many distance table
+ * every source is one query stopping when all targets are settled,
+ * queries run in parallel on @pool, every worker reuses its own workspace
+ * may throw exceptions (for vertices out of range)
+ * @param graph graph to search
+ * @param sources source vertices (rows of the table)
+ * @param targets target vertices (columns of the table)
+ * @param pool threads running the queries
+ * @return table[i][j] is the distance from sources[i] to targets[j]
+ * (MY_MAX if unreachable)
+ */
+inline std::vector<std::vector<unsigned>>
+distanceTable(const CsrGraph &graph, const std::vector<unsigned> &sources,
+              const std::vector<unsigned> &targets, ThreadPool &pool) {
+  std::vector<std::vector<unsigned>> table(sources.size());
+  DijkstraOptions options;
+  options.targets = targets;
+
+  pool.parallelFor(sources.size(), [&](size_t begin, size_t end, unsigned) {
+    DijkstraWorkspace workspace;
+    for (size_t i = begin; i < end; ++i) {
+      workspace.run(graph, sources[i], options);
+      std::vector<unsigned> &row = table[i];
+      row.reserve(targets.size());
+      for (unsigned target : targets)
+        row.push_back(workspace.distance(target));
+    }
+  });
+  return table;
+}
+
+#endif // FIBHEAP_PATHQUERIES_HPP
@@ -0,0 +1,146 @@
+#ifndef FIBHEAP_PERFCOUNTERS_HPP
+#define FIBHEAP_PERFCOUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * Hardware performance counters of the calling thread (Linux perf_event_open)
+ * every event is opened separately, so the kernel may multiplex them; counts
+ * are scaled by the fraction of time the event was really counting
+ * events which cannot be opened (no PMU, virtual machine,
+ * perf_event_paranoid) are skipped
+ */
+class PerfCounters {
+public:
+  /**
+   * description of a single event, type and config as in perf_event_attr
+   */
+  struct Event {
+    std::string name;
+    uint32_t type;
+    uint64_t config;
+  };
+
+  /**
+   *
+   * @return cycles, instructions, L1 data cache read misses, last level cache
+   * misses, branch misses and data TLB read misses
+   */
+  static std::vector<Event> defaultEvents() {
+    const uint64_t readMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    return {
+        {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"l1d_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | readMiss},
+        {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {"dtlb_misses", PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_DTLB | readMiss}};
+  }
+
+  /**
+   * opens the events (disabled), user space only
+   * @param events events to count
+   */
+  explicit PerfCounters(const std::vector<Event> &events = defaultEvents())
+      : m_counters() {
+    for (const Event &event : events) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = event.type;
+      attr.config = event.config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format =
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fd >= 0)
+        m_counters.push_back(Counter{event.name, static_cast<int>(fd), 0});
+    }
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  ~PerfCounters() {
+    for (const Counter &counter : m_counters)
+      ::close(counter.fd);
+  }
+
+  /**
+   *
+   * @return false if no event could be opened
+   */
+  bool available() const { return !m_counters.empty(); }
+
+  /**
+   * resets and enables all events
+   */
+  void start() {
+    for (const Counter &counter : m_counters)
+      ::ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+    for (const Counter &counter : m_counters)
+      ::ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  /**
+   * disables all events and adds their counts to the totals
+   */
+  void stop() {
+    for (const Counter &counter : m_counters)
+      ::ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+    for (Counter &counter : m_counters) {
+      // value, time enabled, time running
+      uint64_t values[3] = {0, 0, 0};
+      if (::read(counter.fd, values, sizeof(values)) !=
+              static_cast<ssize_t>(sizeof(values)) ||
+          values[2] == 0)
+        continue;
+      counter.total += static_cast<double>(values[0]) *
+                       static_cast<double>(values[1]) /
+                       static_cast<double>(values[2]);
+    }
+  }
+
+  /**
+   * sets all totals to zero
+   */
+  void clear() {
+    for (Counter &counter : m_counters)
+      counter.total = 0;
+  }
+
+  /**
+   *
+   * @return names and scaled counts of the opened events summed over all
+   * start - stop regions since the last clear
+   */
+  std::vector<std::pair<std::string, double>> totals() const {
+    std::vector<std::pair<std::string, double>> result;
+    for (const Counter &counter : m_counters)
+      result.emplace_back(counter.name, counter.total);
+    return result;
+  }
+
+private:
+  struct Counter {
+    std::string name;
+    int fd;
+    double total;
+  };
+
+  std::vector<Counter> m_counters;
+};
+
+#endif // FIBHEAP_PERFCOUNTERS_HPP
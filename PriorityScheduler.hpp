@@ -0,0 +1,190 @@
+#ifndef FIBHEAP_PRIORITYSCHEDULER_HPP
+#define FIBHEAP_PRIORITYSCHEDULER_HPP
+
+#include "FibHeap.hpp"
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * executor resuming suspended coroutines in order of their priority
+ * coroutine suspends with co_await scheduler.schedule(priority)
+ * and is resumed by one of the worker threads, highest priority first
+ * (coroutines with the same priority are resumed in FIFO order)
+ * once shutdown has started, co_await does not suspend and the coroutine
+ * continues on the awaiting thread
+ */
+class PriorityScheduler {
+public:
+  using Ticket = unsigned long long;
+
+  /**
+   * awaitable returned by schedule
+   * suspends the coroutine and enqueues its handle into the scheduler
+   * (the coroutine is not suspended if the scheduler is shutting down)
+   */
+  class Awaitable {
+  public:
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle) {
+      return m_scheduler.enqueue(handle, m_priority, m_ticket);
+    }
+    void await_resume() const noexcept {}
+
+  private:
+    Awaitable(PriorityScheduler &scheduler, int priority, Ticket *ticket)
+        : m_scheduler(scheduler), m_priority(priority), m_ticket(ticket) {}
+
+    PriorityScheduler &m_scheduler;
+    int m_priority;
+    Ticket *m_ticket;
+
+    friend class PriorityScheduler;
+  };
+
+  /**
+   * creates scheduler and starts its workers
+   * @param threads number of worker threads, 0 means hardware concurrency
+   */
+  explicit PriorityScheduler(unsigned threads = 0)
+      : m_mutex(), m_ready(), m_handlers(), m_queue(), m_workers(),
+        m_nextTicket(0), m_stop(false) {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; ++i)
+      m_workers.emplace_back(&PriorityScheduler::workerLoop, this);
+  }
+
+  PriorityScheduler(const PriorityScheduler &) = delete;
+  PriorityScheduler &operator=(const PriorityScheduler &) = delete;
+
+  ~PriorityScheduler() { shutdown(); }
+
+  /**
+   * suspends the awaiting coroutine until a worker resumes it
+   * @param priority higher priority is resumed first
+   * @param ticket if not nullptr, receives ticket for reprioritize
+   * @return awaitable to co_await on
+   */
+  Awaitable schedule(int priority, Ticket *ticket = nullptr) {
+    return Awaitable(*this, priority, ticket);
+  }
+
+  /**
+   * raises priority of a coroutine which is still waiting
+   * may throw exceptions (for priority not higher than the current one)
+   * @param ticket ticket received from schedule
+   * @param priority new priority
+   * @return false if the coroutine has already been resumed
+   */
+  bool reprioritize(Ticket ticket, int priority) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_handlers.find(ticket);
+    if (it == m_handlers.end())
+      return false;
+
+    Entry entry = it->second.value();
+    if (priority <= entry.priority)
+      throw std::invalid_argument("New priority has to be higher!");
+    entry.priority = priority;
+    m_queue.increase_key(it->second, entry);
+    return true;
+  }
+
+  /**
+   *
+   * @return number of coroutines waiting to be resumed
+   */
+  size_t pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+  }
+
+  /**
+   * resumes all waiting coroutines and stops the workers
+   * may throw exceptions (if called from a worker, which cannot join itself)
+   */
+  void shutdown() {
+    for (const std::thread &worker : m_workers) {
+      if (worker.get_id() == std::this_thread::get_id())
+        throw std::logic_error("Scheduler shut down from its worker!");
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_ready.notify_all();
+    for (std::thread &worker : m_workers) {
+      if (worker.joinable())
+        worker.join();
+    }
+  }
+
+private:
+  /**
+   * single waiting coroutine
+   * ticket keeps FIFO order among coroutines with the same priority
+   */
+  struct Entry {
+    int priority;
+    Ticket ticket;
+    std::coroutine_handle<> handle;
+  };
+
+  struct cmpEntry {
+    bool operator()(const Entry &first, const Entry &second) const {
+      return first.priority == second.priority ? first.ticket > second.ticket
+                                               : first.priority < second.priority;
+    }
+  };
+
+  /**
+   * @return false if the scheduler is shutting down and the coroutine has
+   * to continue without suspending (its ticket is never valid)
+   */
+  bool enqueue(std::coroutine_handle<> handle, int priority, Ticket *ticket) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      Ticket id = m_nextTicket++;
+      if (ticket)
+        *ticket = id;
+      if (m_stop)
+        return false;
+      m_handlers.emplace(id, m_queue.insert(Entry{priority, id, handle}));
+    }
+    m_ready.notify_one();
+    return true;
+  }
+
+  void workerLoop() {
+    while (true) {
+      std::coroutine_handle<> handle;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_ready.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty())
+          return;
+
+        Entry entry = m_queue.top();
+        m_queue.extract_top();
+        m_handlers.erase(entry.ticket);
+        handle = entry.handle;
+      }
+      handle.resume();
+    }
+  }
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_ready;
+  std::unordered_map<Ticket, FibHeap<Entry, cmpEntry>::Handler> m_handlers;
+  FibHeap<Entry, cmpEntry> m_queue;
+  std::vector<std::thread> m_workers;
+  Ticket m_nextTicket;
+  bool m_stop;
+};
+
+#endif // FIBHEAP_PRIORITYSCHEDULER_HPP
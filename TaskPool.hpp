@@ -0,0 +1,261 @@
+#ifndef FIBHEAP_TASKPOOL_HPP
+#define FIBHEAP_TASKPOOL_HPP
+
+#include "FibHeap.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * pool of workers running prioritized tasks
+ * every worker owns a Fibonacci heap of tasks and runs its best task first,
+ * an idle worker steals a whole tree of tasks from another worker
+ * (FibHeap::splitTree), so the priority order is mostly local
+ * but the load gets balanced cheaply
+ */
+class WorkStealingPool {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * creates pool and starts its workers
+   * @param threads number of workers, 0 means hardware concurrency
+   * @param stealing if false, workers run only their own tasks
+   */
+  explicit WorkStealingPool(unsigned threads = 0, bool stealing = true)
+      : m_workers(), m_threads(), m_idleMutex(), m_idle(), m_done(),
+        m_unfinished(0), m_nextWorker(0), m_steals(0), m_error(),
+        m_stealing(stealing), m_stop(false) {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; ++i)
+      m_workers.push_back(std::make_unique<Worker>());
+    for (unsigned i = 0; i < threads; ++i)
+      m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+  }
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  ~WorkStealingPool() {
+    {
+      std::unique_lock<std::mutex> lock(m_idleMutex);
+      m_done.wait(lock, [this] { return m_unfinished == 0; });
+      m_stop = true;
+    }
+    m_idle.notify_all();
+    for (std::thread &t : m_threads)
+      t.join();
+  }
+
+  /**
+   * adds task to the pool
+   * task submitted from a worker of this pool goes to that worker,
+   * other tasks are distributed between workers in round robin
+   * @param priority higher priority runs first
+   * @param task task to run
+   */
+  void submit(int priority, Task task) {
+    unsigned worker = t_pool == this
+                          ? t_worker
+                          : m_nextWorker++ % static_cast<unsigned>(size());
+    submit(worker, priority, std::move(task));
+  }
+
+  /**
+   * adds task to the heap of the given worker
+   * @param worker index of the worker
+   * @param priority higher priority runs first
+   * @param task task to run
+   */
+  void submit(unsigned worker, int priority, Task task) {
+    m_unfinished++;
+    {
+      Worker &w = *m_workers.at(worker);
+      std::lock_guard<std::mutex> lock(w.mutex);
+      w.tasks.insert(Item{priority, w.sequence++, std::move(task)});
+    }
+    wakeIdle();
+  }
+
+  /**
+   * waits until all submitted tasks (including the spawned ones) finish
+   * rethrows the first exception thrown by a task
+   */
+  void wait() {
+    std::unique_lock<std::mutex> lock(m_idleMutex);
+    m_done.wait(lock, [this] { return m_unfinished == 0; });
+    if (m_error) {
+      std::exception_ptr error = m_error;
+      m_error = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  /**
+   *
+   * @return number of workers
+   */
+  size_t size() const { return m_workers.size(); }
+
+  /**
+   *
+   * @return number of successful steals so far
+   */
+  size_t steals() const { return m_steals; }
+
+private:
+  /**
+   * single task in the heap of a worker
+   * sequence keeps FIFO order among tasks with the same priority
+   */
+  struct Item {
+    int priority;
+    unsigned long long sequence;
+    Task task;
+  };
+
+  struct cmpItem {
+    bool operator()(const Item &first, const Item &second) const {
+      return first.priority == second.priority
+                 ? first.sequence > second.sequence
+                 : first.priority < second.priority;
+    }
+  };
+
+  struct Worker {
+    Worker() : mutex(), tasks(), sequence(0) {}
+
+    std::mutex mutex;
+    FibHeap<Item, cmpItem> tasks;
+    unsigned long long sequence;
+  };
+
+  /**
+   * takes the best task of a worker
+   * @param worker index of the worker
+   * @param task task to fill
+   * @return false if the worker has no tasks
+   */
+  bool takeTask(unsigned worker, Task &task) {
+    Worker &w = *m_workers[worker];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    if (w.tasks.empty())
+      return false;
+    task = w.tasks.top().task;
+    w.tasks.extract_top();
+    return true;
+  }
+
+  /**
+   * moves one tree of tasks from another worker to the heap of @worker
+   * @param worker index of the stealing worker
+   * @return true if some tasks were stolen
+   */
+  bool steal(unsigned worker) {
+    const unsigned count = static_cast<unsigned>(size());
+    for (unsigned i = 1; i < count; ++i) {
+      Worker &victim = *m_workers[(worker + i) % count];
+      FibHeap<Item, cmpItem> stolen;
+      {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        stolen = victim.tasks.splitTree();
+      }
+      if (stolen.empty())
+        continue;
+
+      {
+        Worker &w = *m_workers[worker];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.tasks.uniteWith(stolen);
+      }
+      m_steals++;
+      // the stolen tree may be split again by other idle workers
+      wakeIdle();
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * checks whether @worker would find a task (in its heap or by stealing)
+   * @param worker index of the worker
+   * @return true if there is a task for the worker
+   */
+  bool hasWork(unsigned worker) {
+    for (unsigned i = 0; i < size(); ++i) {
+      if (i != worker && !m_stealing)
+        continue;
+      Worker &w = *m_workers[i];
+      std::lock_guard<std::mutex> lock(w.mutex);
+      // splitTree always leaves the top, so only heaps of 2+ can be robbed
+      if (w.tasks.size() >= (i == worker ? 1 : 2))
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * wakes idle workers after new work appeared in some heap
+   */
+  void wakeIdle() {
+    // an idle worker checks hasWork under m_idleMutex, so passing through
+    // it here makes sure the worker is either waiting or sees the new work
+    { std::lock_guard<std::mutex> lock(m_idleMutex); }
+    m_idle.notify_all();
+  }
+
+  void workerLoop(unsigned index) {
+    t_pool = this;
+    t_worker = index;
+    Task task;
+    while (true) {
+      if (takeTask(index, task) || (m_stealing && steal(index) &&
+                                    takeTask(index, task))) {
+        try {
+          task();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(m_idleMutex);
+          if (!m_error)
+            m_error = std::current_exception();
+        }
+        task = nullptr;
+        if (--m_unfinished == 0) {
+          std::lock_guard<std::mutex> lock(m_idleMutex);
+          m_done.notify_all();
+        }
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(m_idleMutex);
+      m_idle.wait(lock, [this, index] { return m_stop || hasWork(index); });
+      if (m_stop)
+        return;
+    }
+  }
+
+  static thread_local WorkStealingPool *t_pool;
+  static thread_local unsigned t_worker;
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::vector<std::thread> m_threads;
+  std::mutex m_idleMutex;
+  std::condition_variable m_idle;
+  std::condition_variable m_done;
+  std::atomic<size_t> m_unfinished;
+  std::atomic<unsigned> m_nextWorker;
+  std::atomic<size_t> m_steals;
+  std::exception_ptr m_error;
+  bool m_stealing;
+  bool m_stop;
+};
+
+inline thread_local WorkStealingPool *WorkStealingPool::t_pool = nullptr;
+inline thread_local unsigned WorkStealingPool::t_worker = 0;
+
+#endif // FIBHEAP_TASKPOOL_HPP
@@ -0,0 +1,145 @@
+#ifndef FIBHEAP_THREADPOOL_HPP
+#define FIBHEAP_THREADPOOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * fixed-size pool of worker threads for fork-join style parallel loops
+ * the calling thread takes part in every job as worker 0, so a pool of size 1
+ * runs everything inline without any synchronization
+ */
+class ThreadPool {
+public:
+  /**
+   * creates pool with @threads workers (including the calling thread)
+   * @param threads number of workers, 0 means hardware concurrency
+   */
+  explicit ThreadPool(unsigned threads = 0)
+      : m_threads(), m_mutex(), m_wake(), m_done(), m_job(nullptr),
+        m_generation(0), m_pending(0), m_error(), m_stop(false) {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < threads; ++i)
+      m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &t : m_threads)
+      t.join();
+  }
+
+  /**
+   *
+   * @return number of workers, including the calling thread
+   */
+  unsigned size() const { return static_cast<unsigned>(m_threads.size()) + 1; }
+
+  /**
+   * runs @job(worker) once on every worker and waits for all of them
+   * the first exception thrown by any worker is rethrown here
+   * @param job function taking index of the worker
+   */
+  void run(const std::function<void(unsigned)> &job) {
+    if (m_threads.empty()) {
+      job(0);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_job = &job;
+      m_pending = static_cast<unsigned>(m_threads.size());
+      m_error = nullptr;
+      ++m_generation;
+    }
+    m_wake.notify_all();
+
+    std::exception_ptr error;
+    try {
+      job(0);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_job = nullptr;
+    if (!error)
+      error = m_error;
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  /**
+   * splits range [0, @count) into one contiguous chunk per worker
+   * and calls @body(begin, end, worker) for every non-empty chunk
+   * @param count size of the range
+   * @param body function processing one chunk
+   */
+  template <typename F> void parallelFor(size_t count, F &&body) {
+    const size_t workers = size();
+    const size_t chunk = (count + workers - 1) / workers;
+    run([&](unsigned worker) {
+      size_t begin = std::min(count, worker * chunk);
+      size_t end = std::min(count, begin + chunk);
+      if (begin < end)
+        body(begin, end, worker);
+    });
+  }
+
+private:
+  void workerLoop(unsigned index) {
+    unsigned long long seen = 0;
+    while (true) {
+      const std::function<void(unsigned)> *job;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+        if (m_stop)
+          return;
+        seen = m_generation;
+        job = m_job;
+      }
+
+      std::exception_ptr error;
+      try {
+        (*job)(index);
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (error && !m_error)
+        m_error = error;
+      if (--m_pending == 0)
+        m_done.notify_one();
+    }
+  }
+
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  const std::function<void(unsigned)> *m_job;
+  unsigned long long m_generation;
+  unsigned m_pending;
+  std::exception_ptr m_error;
+  bool m_stop;
+};
+
+#endif // FIBHEAP_THREADPOOL_HPP
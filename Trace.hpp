@@ -0,0 +1,319 @@
+#ifndef FIBHEAP_TRACE_HPP
+#define FIBHEAP_TRACE_HPP
+
+#include "FibHeap.hpp"
+#include "Workload.hpp"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Traces of heap operations are stored as Workload (ids of items instead of
+ * Handlers, keys instead of values), so they can be replayed by runWorkload
+ * against any engine of HeapEngines.hpp
+ *
+ * binary format: "FHTR", version byte, number of keys, keys, number of
+ * operations and the operations (type byte followed by its fields), all
+ * numbers are LEB128 varints
+ */
+
+inline void writeTraceNumber(std::ostream &out, unsigned long long number) {
+  do {
+    unsigned char byte = number & 0x7f;
+    number >>= 7;
+    if (number)
+      byte |= 0x80;
+    out.put(static_cast<char>(byte));
+  } while (number);
+}
+
+/**
+ * may throw exceptions (for truncated or corrupted number)
+ */
+inline unsigned long long readTraceNumber(std::istream &in) {
+  unsigned long long number = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    int byte = in.get();
+    if (byte == std::char_traits<char>::eof())
+      throw std::runtime_error("Truncated trace!");
+    number |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return number;
+  }
+  throw std::runtime_error("Invalid number in trace!");
+}
+
+/**
+ * writes @trace in the binary format
+ * @param out binary stream
+ * @param trace recorded operations
+ */
+inline void writeTrace(std::ostream &out, const Workload &trace) {
+  out.write("FHTR\1", 5);
+  writeTraceNumber(out, trace.keys.size());
+  for (unsigned long long key : trace.keys)
+    writeTraceNumber(out, key);
+  writeTraceNumber(out, trace.operations.size());
+  for (const WorkloadOperation &operation : trace.operations) {
+    out.put(static_cast<char>(operation.type));
+    switch (operation.type) {
+    case WorkloadOperation::Push:
+    case WorkloadOperation::Decrease:
+      writeTraceNumber(out, operation.id);
+      writeTraceNumber(out, operation.key);
+      break;
+    case WorkloadOperation::Erase:
+      writeTraceNumber(out, operation.id);
+      break;
+    case WorkloadOperation::Merge:
+      writeTraceNumber(out, operation.id);
+      writeTraceNumber(out, operation.count);
+      break;
+    case WorkloadOperation::Pop:
+      break;
+    }
+  }
+}
+
+/**
+ * reads trace written by writeTrace
+ * the trace is simulated, so it can be replayed by any workload engine:
+ * every item is pushed (or merged) once, only items in the heap are
+ * decreased (to a lower key) or erased and the heap is not empty on pop
+ * may throw exceptions (for invalid trace, ids out of range)
+ * @param in binary stream
+ * @return recorded operations
+ */
+inline Workload readTrace(std::istream &in) {
+  char magic[5];
+  if (!in.read(magic, 5) || std::string(magic, 4) != "FHTR" || magic[4] != 1)
+    throw std::runtime_error("Invalid trace header!");
+
+  // the counts are not trusted, memory grows only with the data read
+  const unsigned long long reserved = 1 << 16;
+  Workload trace;
+  unsigned long long count = readTraceNumber(in);
+  if (count > std::numeric_limits<unsigned>::max())
+    throw std::runtime_error("Too many items in trace!");
+  trace.keys.reserve(std::min(count, reserved));
+  for (unsigned long long i = 0; i < count; ++i)
+    trace.keys.push_back(readTraceNumber(in));
+
+  // (current key, id) of items in the heap, state of every item
+  enum State : unsigned char { Unseen, Live, Gone };
+  std::set<std::pair<unsigned long long, unsigned>> heap;
+  std::vector<unsigned long long> current(trace.keys);
+  std::vector<State> state(trace.keys.size(), Unseen);
+  auto id = [&](State expected) {
+    unsigned long long number = readTraceNumber(in);
+    if (number >= trace.keys.size())
+      throw std::runtime_error("Item of trace out of range!");
+    if (state[number] != expected)
+      throw std::runtime_error("Invalid state of item in trace!");
+    return static_cast<unsigned>(number);
+  };
+
+  count = readTraceNumber(in);
+  trace.operations.reserve(std::min(count, reserved));
+  for (unsigned long long i = 0; i < count; ++i) {
+    int type = in.get();
+    WorkloadOperation operation{WorkloadOperation::Pop, 0, 0, 0};
+    switch (type) {
+    case WorkloadOperation::Push:
+      operation.type = WorkloadOperation::Push;
+      operation.id = id(Unseen);
+      operation.key = readTraceNumber(in);
+      current[operation.id] = operation.key;
+      state[operation.id] = Live;
+      heap.emplace(operation.key, operation.id);
+      break;
+    case WorkloadOperation::Decrease:
+      operation.type = WorkloadOperation::Decrease;
+      operation.id = id(Live);
+      operation.key = readTraceNumber(in);
+      if (operation.key >= current[operation.id])
+        throw std::runtime_error("Key of trace is not decreased!");
+      heap.erase(std::make_pair(current[operation.id], operation.id));
+      current[operation.id] = operation.key;
+      heap.emplace(operation.key, operation.id);
+      break;
+    case WorkloadOperation::Erase:
+      operation.type = WorkloadOperation::Erase;
+      operation.id = id(Live);
+      heap.erase(std::make_pair(current[operation.id], operation.id));
+      state[operation.id] = Gone;
+      break;
+    case WorkloadOperation::Merge: {
+      operation.type = WorkloadOperation::Merge;
+      operation.id = id(Unseen);
+      unsigned long long items = readTraceNumber(in);
+      if (items > trace.keys.size() - operation.id)
+        throw std::runtime_error("Item of trace out of range!");
+      operation.count = static_cast<unsigned>(items);
+      for (unsigned item = operation.id; item < operation.id + operation.count;
+           ++item) {
+        if (state[item] != Unseen)
+          throw std::runtime_error("Invalid state of item in trace!");
+        state[item] = Live;
+        heap.emplace(current[item], item);
+      }
+      break;
+    }
+    case WorkloadOperation::Pop:
+      if (heap.empty())
+        throw std::runtime_error("Pop from empty heap in trace!");
+      state[heap.begin()->second] = Gone;
+      heap.erase(heap.begin());
+      break;
+    default:
+      throw std::runtime_error("Invalid operation in trace!");
+    }
+    trace.operations.push_back(operation);
+  }
+  return trace;
+}
+
+/**
+ * may throw exceptions (when file cannot be opened, for invalid trace)
+ */
+inline void saveTrace(const std::string &path, const Workload &trace) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error("Cannot open file " + path + "!");
+  writeTrace(file, trace);
+}
+
+inline Workload loadTrace(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error("Cannot open file " + path + "!");
+  return readTrace(file);
+}
+
+/**
+ * FibHeap recording every operation into a trace
+ * items are addressed by ids (order of insertion) instead of Handlers,
+ * the trace stores key(value), which has to be lower for values closer to
+ * the top (e.g. -value for the default maximal heap of integers)
+ * of equal values the one with the lower id is the top, as in the replay
+ */
+template <typename Value, typename Compare = std::less<Value>>
+class TracingFibHeap {
+public:
+  using KeyFunction = std::function<unsigned long long(const Value &)>;
+
+  explicit TracingFibHeap(KeyFunction key)
+      : m_key(std::move(key)), m_trace(), m_handlers(), m_heap() {}
+
+  TracingFibHeap(const TracingFibHeap &) = delete;
+  TracingFibHeap &operator=(const TracingFibHeap &) = delete;
+
+  /**
+   * inserts @value
+   * @return id of the new item
+   */
+  unsigned insert(const Value &value) {
+    unsigned id = add(value);
+    m_handlers[id].emplace(m_heap.insert(Item{value, id}));
+    m_trace.operations.push_back(
+        {WorkloadOperation::Push, id, m_trace.keys[id], 0});
+    return id;
+  }
+
+  const Value &top() const { return m_heap.top().value; }
+
+  /**
+   *
+   * @return id of the top item
+   */
+  unsigned top_id() const { return m_heap.top().id; }
+
+  void extract_top() {
+    unsigned id = m_heap.top().id;
+    m_heap.extract_top();
+    m_handlers[id].reset();
+    m_trace.operations.push_back({WorkloadOperation::Pop, 0, 0, 0});
+  }
+
+  /**
+   * may throw exceptions (same as FibHeap::increase_key)
+   */
+  void increase_key(unsigned id, const Value &value) {
+    m_heap.increase_key(*m_handlers[id], Item{value, id});
+    m_trace.operations.push_back(
+        {WorkloadOperation::Decrease, id, m_key(value), 0});
+  }
+
+  void delete_value(unsigned id) {
+    m_heap.delete_value(*m_handlers[id]);
+    m_handlers[id].reset();
+    m_trace.operations.push_back({WorkloadOperation::Erase, id, 0, 0});
+  }
+
+  /**
+   * builds a heap of @values and unites it with this one
+   * @return id of the first new item, the others follow
+   */
+  unsigned merge(const std::vector<Value> &values) {
+    unsigned first = static_cast<unsigned>(m_handlers.size());
+    Heap other;
+    for (const Value &value : values) {
+      unsigned id = add(value);
+      m_handlers[id].emplace(other.insert(Item{value, id}));
+    }
+    m_heap.uniteWith(other);
+    m_trace.operations.push_back({WorkloadOperation::Merge, first, 0,
+                                  static_cast<unsigned>(values.size())});
+    return first;
+  }
+
+  size_t size() const { return m_heap.size(); }
+  bool empty() const { return m_heap.empty(); }
+
+  const Workload &trace() const { return m_trace; }
+
+private:
+  struct Item {
+    Value value;
+    unsigned id;
+  };
+
+  struct cmpItem {
+    cmpItem() : compare() {}
+
+    bool operator()(const Item &first, const Item &second) {
+      if (compare(first.value, second.value))
+        return true;
+      if (compare(second.value, first.value))
+        return false;
+      return first.id > second.id;
+    }
+
+    Compare compare;
+  };
+
+  using Heap = FibHeap<Item, cmpItem>;
+
+  unsigned add(const Value &value) {
+    unsigned id = static_cast<unsigned>(m_handlers.size());
+    m_trace.keys.push_back(m_key(value));
+    m_handlers.emplace_back();
+    return id;
+  }
+
+  KeyFunction m_key;
+  Workload m_trace;
+  std::vector<std::optional<typename Heap::Handler>> m_handlers;
+  Heap m_heap;
+};
+
+#endif // FIBHEAP_TRACE_HPP
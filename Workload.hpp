@@ -0,0 +1,241 @@
+#ifndef FIBHEAP_WORKLOAD_HPP
+#define FIBHEAP_WORKLOAD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Single operation of a generated workload
+ * Push inserts item @id with @key, Pop extracts the lowest key,
+ * Decrease lowers key of item @id to @key, Erase removes item @id,
+ * Merge melds a separately built heap of items @id .. @id + @count - 1
+ */
+struct WorkloadOperation {
+  enum Type : unsigned char { Push, Pop, Decrease, Erase, Merge };
+
+  Type type;
+  unsigned id;
+  unsigned long long key;
+  unsigned count;
+};
+
+/**
+ * Generated sequence of operations
+ * keys holds the initial key of every item (indexed by id)
+ */
+struct Workload {
+  Workload() : operations(), keys() {}
+
+  std::vector<WorkloadOperation> operations;
+  std::vector<unsigned long long> keys;
+};
+
+/**
+ * Random source of keys (or increments in the hold model)
+ * uniform     - uniform in [0, 2^32)
+ * exponential - exponential with mean 2^16
+ * sorted      - increasing
+ * reverse     - decreasing
+ * duplicates  - one of 8 values
+ */
+class KeyDistribution {
+public:
+  /**
+   * may throw exceptions (for unknown distribution)
+   */
+  KeyDistribution(const std::string &name, unsigned seed)
+      : m_kind(kind(name)), m_generator(seed), m_counter(0) {}
+
+  unsigned long long next() {
+    switch (m_kind) {
+    case Uniform:
+      return m_generator() & 0xffffffffULL;
+    case Exponential: {
+      double u = (m_generator() >> 11) * (1.0 / 9007199254740992.0);
+      return static_cast<unsigned long long>(-std::log1p(-u) * 65536);
+    }
+    case Sorted:
+      return m_counter++;
+    case Reverse:
+      return (1ULL << 40) - m_counter++;
+    default:
+      return (m_generator() % 8) << 20;
+    }
+  }
+
+private:
+  enum Kind { Uniform, Exponential, Sorted, Reverse, Duplicates };
+
+  static Kind kind(const std::string &name) {
+    if (name == "uniform")
+      return Uniform;
+    if (name == "exponential")
+      return Exponential;
+    if (name == "sorted")
+      return Sorted;
+    if (name == "reverse")
+      return Reverse;
+    if (name == "duplicates")
+      return Duplicates;
+    throw std::invalid_argument("Unknown key distribution " + name + "!");
+  }
+
+  Kind m_kind;
+  std::mt19937_64 m_generator;
+  unsigned long long m_counter;
+};
+
+/**
+ * Generates workload of about @operations operations on a heap of about
+ * @size items (items are prefilled, except for sorting)
+ * hold       - pop, then push the popped key plus a random increment
+ * sorting    - rounds of pushing @size keys and popping all of them
+ * decrease   - 20 % push, 20 % pop, 60 % decrease of a random item
+ * delete     - 35 % push, 25 % pop, 40 % erase of a random item
+ * merge      - merge of @size / 16 new items, then as many pops
+ * the heap is simulated with ties broken by lower id, so the order of popped
+ * items is the same for all engines
+ * may throw exceptions (for unknown mix or distribution)
+ * @param mix kind of the workload
+ * @param distribution name of KeyDistribution
+ * @param size size of the heap
+ * @param operations number of operations after prefill
+ * @param seed seed of the random generators
+ * @return generated workload
+ */
+inline Workload generateWorkload(const std::string &mix,
+                                 const std::string &distribution, size_t size,
+                                 size_t operations, unsigned seed) {
+  if (mix != "hold" && mix != "sorting" && mix != "decrease" &&
+      mix != "delete" && mix != "merge")
+    throw std::invalid_argument("Unknown workload mix " + mix + "!");
+
+  Workload workload;
+  KeyDistribution keys(distribution, seed);
+  std::mt19937_64 generator(seed + 1);
+  std::set<std::pair<unsigned long long, unsigned>> heap;
+  // current key of every id, ids in the heap and position of every id in live
+  std::vector<unsigned long long> current;
+  std::vector<unsigned> live;
+  std::vector<size_t> position;
+
+  auto push = [&](unsigned long long key) {
+    unsigned id = static_cast<unsigned>(workload.keys.size());
+    workload.keys.push_back(key);
+    current.push_back(key);
+    position.push_back(live.size());
+    live.push_back(id);
+    heap.emplace(key, id);
+    return id;
+  };
+  auto remove = [&](unsigned id) {
+    heap.erase(std::make_pair(current[id], id));
+    live[position[id]] = live.back();
+    position[live.back()] = position[id];
+    live.pop_back();
+  };
+  auto pop = [&] {
+    auto top = *heap.begin();
+    remove(top.second);
+    workload.operations.push_back({WorkloadOperation::Pop, 0, 0, 0});
+    return top.first;
+  };
+  auto pushOperation = [&](unsigned long long key) {
+    unsigned id = push(key);
+    workload.operations.push_back({WorkloadOperation::Push, id, key, 0});
+  };
+
+  if (mix != "sorting") {
+    for (size_t i = 0; i < size; ++i)
+      pushOperation(keys.next());
+  }
+
+  size_t done = 0;
+  while (done < operations) {
+    if (mix == "hold") {
+      unsigned long long key = heap.empty() ? 0 : pop();
+      pushOperation(key + keys.next());
+      done += 2;
+    } else if (mix == "sorting") {
+      for (size_t i = 0; i < size; ++i)
+        pushOperation(keys.next());
+      while (!heap.empty())
+        pop();
+      done += 2 * size;
+    } else if (mix == "merge") {
+      unsigned count = static_cast<unsigned>(std::max<size_t>(1, size / 16));
+      unsigned first = static_cast<unsigned>(workload.keys.size());
+      for (unsigned i = 0; i < count; ++i)
+        push(keys.next());
+      workload.operations.push_back(
+          {WorkloadOperation::Merge, first, 0, count});
+      for (unsigned i = 0; i < count; ++i)
+        pop();
+      done += count + 1;
+    } else {
+      unsigned roll = static_cast<unsigned>(generator() % 100);
+      const bool decrease = mix == "decrease";
+      if (heap.empty() || roll < (decrease ? 20u : 35u)) {
+        pushOperation(keys.next());
+      } else if (roll < (decrease ? 40u : 60u)) {
+        pop();
+      } else {
+        unsigned id = live[generator() % live.size()];
+        if (decrease) {
+          unsigned long long key = current[id];
+          if (key > 0) {
+            unsigned long long lower = generator() % key;
+            heap.erase(std::make_pair(key, id));
+            heap.emplace(lower, id);
+            current[id] = lower;
+            workload.operations.push_back(
+                {WorkloadOperation::Decrease, id, lower, 0});
+          }
+        } else {
+          remove(id);
+          workload.operations.push_back({WorkloadOperation::Erase, id, 0, 0});
+        }
+      }
+      done++;
+    }
+  }
+  return workload;
+}
+
+/**
+ * runs @workload on @engine, an engine of HeapEngines.hpp with keys of
+ * unsigned long long (pushes and decreases are offers)
+ * @return checksum of the order of popped items (equal for all engines)
+ */
+template <typename Engine>
+unsigned long long runWorkload(Engine &engine, const Workload &workload) {
+  engine.reset(workload.keys.size());
+  unsigned long long checksum = 0;
+  for (const WorkloadOperation &operation : workload.operations) {
+    switch (operation.type) {
+    case WorkloadOperation::Push:
+    case WorkloadOperation::Decrease:
+      engine.offer(operation.id, operation.key);
+      break;
+    case WorkloadOperation::Pop:
+      checksum = checksum * 1000003 + engine.top();
+      engine.pop();
+      break;
+    case WorkloadOperation::Erase:
+      engine.erase(operation.id);
+      break;
+    case WorkloadOperation::Merge:
+      engine.merge(operation.id, operation.count, workload.keys.data());
+      break;
+    }
+  }
+  return checksum;
+}
+
+#endif // FIBHEAP_WORKLOAD_HPP
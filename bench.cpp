@@ -0,0 +1,1202 @@
+#include "Benchmark.hpp"
+#include "FibHeap.hpp"
+#include "Graph.hpp"
+#include "GraphAlgorithms.hpp"
+#include "GraphGenerators.hpp"
+#include "GraphLoader.hpp"
+#include "GraphSnapshot.hpp"
+#include "HeapEngines.hpp"
+#include "LatencyHistogram.hpp"
+#include "PathQueries.hpp"
+#include "PriorityScheduler.hpp"
+#include "TaskPool.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include "Workload.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <coroutine>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Structure for coparison of strings
+ * (Makes copies of string)
+ */
+struct compareString_copy {
+  bool operator()(const std::string &a, const std::string &b) {
+    if (a.size() != b.size())
+      return (a.size() < b.size());
+    std::string cpyA = a;
+    std::string cpyB = b;
+    std::transform(cpyA.begin(), cpyA.end(), cpyA.begin(), ::tolower);
+    std::transform(cpyB.begin(), cpyB.end(), cpyB.begin(), ::tolower);
+    return cpyA < cpyB;
+  }
+};
+
+/**
+ * Structure for coparison of strings
+ * (Does not make any copies)
+ */
+struct compareString_nocopy {
+  bool operator()(std::string &a, std::string &b) {
+    if (a.size() != b.size())
+      return (a.size() < b.size());
+    std::transform(a.begin(), a.end(), a.begin(), ::tolower);
+    std::transform(b.begin(), b.end(), b.begin(), ::tolower);
+    return a < b;
+  }
+};
+
+bool isNotAlpha(int ch) { return !isalpha(ch); }
+
+/**
+ * Removes all non-alphabetic characters
+ * @param word a string to be modified
+ * @return modified string
+ */
+bool modify(std::string &word) {
+  word.erase(std::remove_if(word.begin(), word.end(), isNotAlpha), word.end());
+  return !word.empty();
+}
+
+/**
+ * Reads words from file and stores them in vectors
+ * @param fileName
+ * @param C_W vector to be filled
+ * @param N_W vector to be filled
+ * @return number of words read
+ */
+int readFile(const std::string &fileName, std::vector<std::string> &C_W,
+             std::vector<std::string> &N_W) {
+  using namespace std;
+  ifstream file;
+  file.open(fileName);
+  if (!file.is_open())
+    return 0;
+
+  int word_count = 0;
+  string word;
+  while (file >> word) {
+    if (modify(word)) {
+      C_W.push_back(word);
+      N_W.push_back(word);
+      ++word_count;
+    }
+  }
+  return word_count;
+}
+
+/**
+ * Generates random integers with a fixed seed, so all engines get the same
+ * input
+ * @param count number of integers
+ * @return generated integers
+ */
+std::vector<int> randomIntegers(size_t count) {
+  std::mt19937 generator(42);
+  std::vector<int> values(count);
+  for (int &value : values)
+    value = static_cast<int>(generator());
+  return values;
+}
+
+/**
+ * Pushes all @values into @queue and empties it
+ * @param queue std::priority_queue or FibHeap
+ * @param values values to push
+ */
+template <typename Queue, typename T>
+void fillAndEmpty(Queue &queue, const std::vector<T> &values) {
+  for (const T &value : values)
+    queue.push(value);
+  while (!queue.empty())
+    queue.pop();
+}
+
+template <typename T, typename Compare>
+void fillAndEmpty(FibHeap<T, Compare> &heap, const std::vector<T> &values) {
+  for (const T &value : values)
+    heap.insert(value);
+  while (!heap.empty())
+    heap.extract_top();
+}
+
+/**
+ * Fill and empty benchmark of one queue type
+ */
+template <typename Queue, typename T>
+void measureFillAndEmpty(BenchmarkRun &run, const std::vector<T> &values) {
+  Queue queue;
+  run.setItems(2.0 * values.size());
+  run.measure([&] { fillAndEmpty(queue, values); });
+}
+
+/**
+ * Pushes @values, pops half of them, pushes them again and empties the queue
+ * (scripted version of the interactive UserTest)
+ */
+template <typename Queue>
+void pushPopInterleaved(Queue &queue, const std::vector<int> &values) {
+  for (int value : values)
+    queue.push(value);
+  for (size_t i = 0; i < values.size() / 2; ++i)
+    queue.pop();
+  for (int value : values)
+    queue.push(value);
+  while (!queue.empty())
+    queue.pop();
+}
+
+/**
+ * FibHeap with the push/pop interface of std::priority_queue
+ */
+template <typename T> struct FibHeapQueue : FibHeap<T> {
+  void push(const T &value) { this->insert(value); }
+  void pop() { this->extract_top(); }
+};
+
+/**
+ * @return adjacency matrix graph with the edges of @generated
+ */
+Graph toMatrix(const GeneratedGraph &generated) {
+  Graph graph(generated.vertices);
+  std::fill(graph.matrix.begin(), graph.matrix.end(), MY_MAX);
+  for (size_t v = 0; v < generated.vertices; ++v)
+    graph.matrix[v * generated.vertices + v] = 0;
+  for (const CsrGraph::Edge &edge : generated.edges) {
+    int &weight = graph.matrix[edge.from * generated.vertices + edge.to];
+    weight = std::min(weight, static_cast<int>(edge.weight));
+  }
+  return graph;
+}
+
+/**
+ * @return sparse graph of the given kind with about @vertices vertices
+ */
+CsrGraph generateGraph(const std::string &kind, size_t vertices) {
+  if (kind == "grid") {
+    size_t side = static_cast<size_t>(std::sqrt(vertices));
+    return generateGrid(side, side, 100, 0.1f, 42).toCsr();
+  }
+  if (kind == "geometric")
+    return generateGeometric(vertices, 6, 1000, 42).toCsr();
+  if (kind == "rmat") {
+    unsigned scale = 0;
+    while ((size_t(2) << scale) <= vertices)
+      ++scale;
+    return generateRMat(scale, 4 * vertices, 100, 42).toCsr();
+  }
+  return generateErdosRenyi(vertices, 4 * vertices, 100, 42).toCsr();
+}
+
+/**
+ * @return @count random vertices of a graph with @vertices vertices
+ */
+std::vector<unsigned> randomVertices(size_t vertices, size_t count,
+                                     unsigned seed) {
+  std::mt19937 generator(seed);
+  std::vector<unsigned> result(count);
+  for (unsigned &v : result)
+    v = static_cast<unsigned>(generator() % vertices);
+  return result;
+}
+
+/**
+ * Coroutine which starts immediately and destroys itself when finished
+ */
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+/**
+ * Waits for the scheduler, then does some work and records its priority
+ */
+DetachedTask scheduledJob(PriorityScheduler &scheduler, int priority,
+                          PriorityScheduler::Ticket *ticket, unsigned work,
+                          std::vector<int> &order, std::mutex &mutex) {
+  co_await scheduler.schedule(priority, ticket);
+  volatile unsigned sink = 0;
+  for (unsigned i = 0; i < work; ++i)
+    sink = sink + i;
+  std::lock_guard<std::mutex> lock(mutex);
+  order.push_back(priority);
+}
+
+/**
+ * Item of the latency benchmark, the lowest key is the top
+ * slot is the position of its Handler
+ */
+struct LatencyItem {
+  unsigned long long key;
+  unsigned slot;
+};
+
+struct cmpLatencyItem {
+  bool operator()(const LatencyItem &first, const LatencyItem &second) const {
+    return first.key > second.key;
+  }
+};
+
+/**
+ * Random sequence of FibHeap operations with a steady heap size
+ * @param heap timed heap prefilled with @handlers
+ * @param handlers Handlers of the items (by slot), nullopt for free slots
+ * @param live slots of the items in the heap
+ * @param percent percentage of insert, extract_top, increase_key and
+ * delete_value operations
+ * @param operations number of operations
+ * @param generator random generator
+ */
+void mixedOperations(
+    TimedFibHeap<LatencyItem, cmpLatencyItem> &heap,
+    std::vector<std::optional<FibHeap<LatencyItem, cmpLatencyItem>::Handler>>
+        &handlers,
+    std::vector<unsigned> &live, const unsigned (&percent)[4],
+    size_t operations, std::mt19937_64 &generator) {
+  // position of every slot in live
+  std::vector<size_t> position(handlers.size());
+  for (size_t i = 0; i < live.size(); ++i)
+    position[live[i]] = i;
+  std::vector<unsigned> freeSlots;
+  for (unsigned slot = 0; slot < handlers.size(); ++slot) {
+    if (!handlers[slot])
+      freeSlots.push_back(slot);
+  }
+  auto remove = [&](unsigned slot) {
+    handlers[slot].reset();
+    live[position[slot]] = live.back();
+    position[live.back()] = position[slot];
+    live.pop_back();
+    freeSlots.push_back(slot);
+  };
+
+  for (size_t i = 0; i < operations; ++i) {
+    unsigned roll = static_cast<unsigned>(generator() % 100);
+    if (roll < percent[0] || live.empty()) {
+      unsigned slot;
+      if (freeSlots.empty()) {
+        slot = static_cast<unsigned>(handlers.size());
+        handlers.emplace_back();
+        position.push_back(0);
+      } else {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+      }
+      handlers[slot].emplace(heap.insert(LatencyItem{generator(), slot}));
+      position[slot] = live.size();
+      live.push_back(slot);
+    } else if (roll < percent[0] + percent[1]) {
+      unsigned slot = heap.heap().top().slot;
+      heap.extract_top();
+      remove(slot);
+    } else {
+      unsigned slot = live[generator() % live.size()];
+      if (roll < percent[0] + percent[1] + percent[2]) {
+        unsigned long long key = handlers[slot]->value().key;
+        if (key > 0)
+          heap.increase_key(*handlers[slot],
+                            LatencyItem{generator() % key, slot});
+      } else {
+        heap.delete_value(*handlers[slot]);
+        remove(slot);
+      }
+    }
+  }
+}
+
+/**
+ * std::priority_queue with access to the capacity of its container
+ */
+template <typename T>
+struct InspectablePriorityQueue : std::priority_queue<T> {
+  size_t capacity() const { return this->c.capacity(); }
+};
+
+/**
+ * Generates random strings of 24 lowercase letters (longer than the short
+ * string buffer, so every string owns heap memory)
+ * @param count number of strings
+ * @return generated strings
+ */
+std::vector<std::string> randomStrings(size_t count) {
+  std::mt19937 generator(42);
+  std::vector<std::string> values(count);
+  for (std::string &value : values) {
+    for (unsigned i = 0; i < 24; ++i)
+      value.push_back(static_cast<char>('a' + generator() % 26));
+  }
+  return values;
+}
+
+/**
+ * payload hooks of memory_usage
+ * @return bytes owned by @value besides its sizeof
+ */
+size_t ownedBytes(int) { return 0; }
+
+size_t ownedBytes(const std::string &value) {
+  // short strings are stored inside the object
+  if (value.capacity() <= std::string().capacity())
+    return 0;
+  return FibHeapMemory::chunk(value.capacity() + 1);
+}
+
+/**
+ * Fills a queue of @engine kind with @values and reports bytes per item
+ * FibHeap reports its memory_usage, the other engines count their
+ * containers and the payload of @values
+ */
+template <typename T>
+void measureMemory(BenchmarkRun &run, const std::vector<T> &values) {
+  const std::string kind = run.param("engine");
+  const double items = static_cast<double>(values.size());
+  size_t payload = 0;
+  for (const T &value : values)
+    payload += ownedBytes(value);
+
+  size_t bytes = 0;
+  run.setItems(items);
+  if (kind == "fibheap") {
+    FibHeap<T> heap;
+    run.measure([&] { heap = FibHeap<T>(); },
+                [&] {
+                  for (const T &value : values)
+                    heap.insert(value);
+                });
+    FibHeapMemory memory =
+        heap.memory_usage([](const T &value) { return ownedBytes(value); });
+    bytes = memory.total();
+    run.counter("node_bytes/item", static_cast<double>(memory.nodes) / items);
+    run.counter("payload_bytes/item",
+                static_cast<double>(memory.payload) / items);
+    run.counter("slack_bytes/item",
+                static_cast<double>(memory.allocatorSlack) / items);
+    run.counter("scratch_bytes", static_cast<double>(memory.scratch));
+  } else if (kind == "priority_queue") {
+    InspectablePriorityQueue<T> queue;
+    run.measure([&] { queue = InspectablePriorityQueue<T>(); },
+                [&] {
+                  for (const T &value : values)
+                    queue.push(value);
+                });
+    bytes = queue.capacity() * sizeof(T) + payload;
+  } else if (kind == "fibheap_engine" || kind == "lazy_queue") {
+    auto fill = [&](auto &engine) {
+      run.measure([&] { engine.reset(values.size()); },
+                  [&] {
+                    for (unsigned id = 0; id < values.size(); ++id)
+                      engine.offer(id, values[id]);
+                  });
+      bytes = engine.memory_usage() + payload;
+    };
+    if (kind == "fibheap_engine") {
+      FibHeapEngine<T> engine;
+      fill(engine);
+    } else {
+      LazyQueueEngine<T> engine;
+      fill(engine);
+    }
+  } else {
+    throw std::invalid_argument("Unknown engine " + kind + "!");
+  }
+  run.counter("bytes/item", static_cast<double>(bytes) / items);
+}
+
+/**
+ * Times about @size / 10 operations of one kind on a heap of @size random
+ * items (rebuilt before every repetition), the working set (the heap of @size
+ * items and its Handlers) is annotated with the smallest cache holding it
+ * insert   - inserts @count new items
+ * extract  - extracts @count tops
+ * decrease - lowers keys of @count random items, std::priority_queue has no
+ *            decrease-key, so it pushes a new entry (as LazyQueueEngine)
+ */
+void measureScalability(BenchmarkRun &run, size_t size,
+                        const std::vector<CacheLevel> &caches) {
+  using Heap = FibHeap<LatencyItem, cmpLatencyItem>;
+  using Queue = std::priority_queue<LatencyItem, std::vector<LatencyItem>,
+                                    cmpLatencyItem>;
+  const std::string operation = run.param("operation");
+  if (operation != "insert" && operation != "extract" &&
+      operation != "decrease")
+    throw std::invalid_argument("Unknown operation " + operation + "!");
+  // keeps the size within 10 %
+  const size_t count = std::min<size_t>(std::max<size_t>(size / 10, 100), size);
+
+  std::mt19937_64 generator(42);
+  std::vector<unsigned long long> keys(size + count);
+  for (unsigned long long &key : keys)
+    key = generator() | 1;
+  std::vector<unsigned> targets(count);
+  for (unsigned &target : targets)
+    target = static_cast<unsigned>(generator() % size);
+
+  run.setItems(static_cast<double>(count));
+  size_t workingSet = 0;
+  if (run.param("engine") == "fibheap") {
+    std::vector<std::optional<Heap::Handler>> handlers;
+    Heap heap;
+    run.measure(
+        [&] {
+          heap = Heap();
+          handlers.clear();
+          handlers.reserve(size + 1);
+          for (unsigned slot = 0; slot < size; ++slot)
+            handlers.emplace_back(heap.insert(LatencyItem{keys[slot], slot}));
+          // consolidates the root list outside of the measurement
+          handlers.emplace_back(heap.insert(LatencyItem{0, unsigned(size)}));
+          heap.extract_top();
+          workingSet =
+              heap.memory_usage().total() +
+              handlers.capacity() * sizeof(std::optional<Heap::Handler>);
+        },
+        [&] {
+          if (operation == "insert") {
+            for (size_t i = size; i < size + count; ++i)
+              heap.insert(LatencyItem{keys[i], static_cast<unsigned>(i)});
+          } else if (operation == "extract") {
+            for (size_t i = 0; i < count; ++i)
+              heap.extract_top();
+          } else {
+            for (unsigned slot : targets) {
+              Heap::Handler &handler = *handlers[slot];
+              heap.increase_key(handler,
+                                LatencyItem{handler.value().key / 2, slot});
+            }
+          }
+          doNotOptimize(heap.top());
+        });
+  } else {
+    Queue queue;
+    run.measure(
+        [&] {
+          std::vector<LatencyItem> items;
+          items.reserve(size + count);
+          for (unsigned slot = 0; slot < size; ++slot)
+            items.push_back(LatencyItem{keys[slot], slot});
+          queue = Queue(cmpLatencyItem(), std::move(items));
+          workingSet = queue.size() * sizeof(LatencyItem);
+        },
+        [&] {
+          if (operation == "insert") {
+            for (size_t i = size; i < size + count; ++i)
+              queue.push(LatencyItem{keys[i], static_cast<unsigned>(i)});
+          } else if (operation == "extract") {
+            for (size_t i = 0; i < count; ++i)
+              queue.pop();
+          } else {
+            for (unsigned slot : targets)
+              queue.push(LatencyItem{keys[slot] / 2, slot});
+          }
+          doNotOptimize(queue.top());
+        });
+  }
+  run.counter("working_set_bytes", static_cast<double>(workingSet));
+  run.label("level", memoryLevel(workingSet, caches));
+}
+
+/**
+ * Benchmarks of the heap and of the algorithms built on it
+ * run with --help-like options described in BenchmarkSuite::main, e.g.
+ * pv264_bench --filter dijkstra --format json --output results.json
+ */
+int main(int argc, char **argv) {
+  using namespace std;
+  BenchmarkSuite suite;
+
+  suite.add("fill_empty/int",
+            {{"size", {"10000", "100000", "1000000"}},
+             {"engine", {"fibheap", "priority_queue"}}},
+            [](BenchmarkRun &run) {
+              vector<int> values = randomIntegers(run.number("size"));
+              if (run.param("engine") == "fibheap")
+                measureFillAndEmpty<FibHeap<int>>(run, values);
+              else
+                measureFillAndEmpty<priority_queue<int>>(run, values);
+            });
+
+  suite.add(
+      "fill_empty/string",
+      {{"file", {"input.txt"}},
+       {"compare", {"copy", "nocopy"}},
+       {"engine", {"fibheap", "priority_queue"}}},
+      [](BenchmarkRun &run) {
+        vector<string> words, unused;
+        if (readFile(run.param("file"), words, unused) == 0)
+          throw runtime_error("No words in file " + run.param("file") + "!");
+        bool fib = run.param("engine") == "fibheap";
+        if (run.param("compare") == "copy") {
+          if (fib)
+            measureFillAndEmpty<FibHeap<string, compareString_copy>>(run,
+                                                                     words);
+          else
+            measureFillAndEmpty<priority_queue<string, vector<string>,
+                                               compareString_copy>>(run, words);
+        } else {
+          if (fib)
+            measureFillAndEmpty<FibHeap<string, compareString_nocopy>>(run,
+                                                                       words);
+          else
+            measureFillAndEmpty<priority_queue<string, vector<string>,
+                                               compareString_nocopy>>(run,
+                                                                      words);
+        }
+      });
+
+  suite.add("push_pop/int",
+            {{"size", {"100000", "1000000"}},
+             {"engine", {"fibheap", "priority_queue"}}},
+            [](BenchmarkRun &run) {
+              vector<int> values = randomIntegers(run.number("size"));
+              run.setItems(4.0 * values.size());
+              if (run.param("engine") == "fibheap") {
+                FibHeapQueue<int> queue;
+                run.measure([&] { pushPopInterleaved(queue, values); });
+              } else {
+                priority_queue<int> queue;
+                run.measure([&] { pushPopInterleaved(queue, values); });
+              }
+            });
+
+  suite.add("range_constructor/int",
+            {{"size", {"1000000"}}, {"threads", {"0", "1", "2", "4"}}},
+            [](BenchmarkRun &run) {
+              // 0 threads means the sequential range constructor
+              vector<int> values = randomIntegers(run.number("size"));
+              unsigned threads = static_cast<unsigned>(run.number("threads"));
+              run.setItems(static_cast<double>(values.size()));
+              run.measure([&] {
+                FibHeap<int> heap =
+                    threads ? FibHeap<int>(values.begin(), values.end(),
+                                           threads)
+                            : FibHeap<int>(values.begin(), values.end());
+                doNotOptimize(heap.top());
+              });
+            });
+
+  suite.add("first_pop/int",
+            {{"size", {"1000000", "10000000"}},
+             {"threads", {"0", "2", "4", "8"}}},
+            [](BenchmarkRun &run) {
+              // the first extract_top consolidates the whole root list,
+              // 0 threads means the sequential consolidation
+              vector<int> values = randomIntegers(run.number("size"));
+              unsigned threads = static_cast<unsigned>(run.number("threads"));
+              FibHeap<int> heap;
+              run.setItems(static_cast<double>(values.size()));
+              run.measure(
+                  [&] {
+                    heap = FibHeap<int>();
+                    if (threads)
+                      heap.setParallelConsolidation(100000, threads);
+                    for (int value : values)
+                      heap.insert(value);
+                  },
+                  [&] { heap.extract_top(); });
+            });
+
+  suite.add("dijkstra/matrix",
+            {{"size", {"1000", "2000"}},
+             {"engine", {"fibheap", "priority_queue"}}},
+            [](BenchmarkRun &run) {
+              size_t size = run.number("size");
+              Graph graph =
+                  toMatrix(generateErdosRenyi(size, 4 * size, 100, 42));
+              bool fib = run.param("engine") == "fibheap";
+              run.setItems(static_cast<double>(size * size));
+              run.measure([&] {
+                vector<unsigned> distances =
+                    fib ? graph.shortestPathFibHeap(0, false, false)
+                        : graph.shortestPathPriorityQueue(0, false, false);
+                doNotOptimize(distances.data());
+              });
+            });
+
+  suite.add("dijkstra/csr",
+            {{"graph", {"grid", "geometric", "rmat"}},
+             {"vertices", {"1000000"}},
+             {"engine", {"fibheap", "priority_queue"}}},
+            [](BenchmarkRun &run) {
+              CsrGraph graph =
+                  generateGraph(run.param("graph"), run.number("vertices"));
+              bool fib = run.param("engine") == "fibheap";
+              run.setItems(static_cast<double>(graph.edgeCount()));
+              run.measure([&] {
+                vector<unsigned> distances =
+                    fib ? graph.shortestPathFibHeap(0, false, false)
+                        : graph.shortestPathPriorityQueue(0, false, false);
+                doNotOptimize(distances.data());
+              });
+            });
+
+  suite.add("dijkstra/delta_stepping",
+            {{"graph", {"random", "grid"}},
+             {"vertices", {"100000", "1000000"}},
+             {"delta", {"10", "100"}},
+             {"threads", {"0", "1", "2", "4", "8"}}},
+            [](BenchmarkRun &run) {
+              // 0 threads means Dijkstra with FibHeap
+              unsigned threads = static_cast<unsigned>(run.number("threads"));
+              CsrGraph graph =
+                  generateGraph(run.param("graph"), run.number("vertices"));
+              optional<ThreadPool> pool;
+              if (threads)
+                pool.emplace(threads);
+              run.setItems(static_cast<double>(graph.edgeCount()));
+              run.measure([&] {
+                vector<unsigned> distances =
+                    threads ? graph.shortestPathDeltaStepping(
+                                  0, static_cast<unsigned>(run.number("delta")),
+                                  *pool, false, false)
+                            : graph.shortestPathFibHeap(0, false, false);
+                doNotOptimize(distances.data());
+              });
+            });
+
+  suite.add("generate",
+            {{"graph", {"random", "grid", "geometric", "rmat"}},
+             {"vertices", {"1000000"}}},
+            [](BenchmarkRun &run) {
+              size_t edges = 0;
+              run.setItems(static_cast<double>(run.number("vertices")));
+              run.measure([&] {
+                CsrGraph graph =
+                    generateGraph(run.param("graph"), run.number("vertices"));
+                edges = graph.edgeCount();
+              });
+              run.counter("edges", static_cast<double>(edges));
+            });
+
+  // loads a DIMACS graph, runs only with a file given, e.g.
+  // pv264_bench --filter load --set dimacs=USA-road-d.USA.gr
+  suite.add("load/dimacs", {{"dimacs", {}}, {"threads", {"1", "2", "4", "8"}}},
+            [](BenchmarkRun &run) {
+              unsigned threads = static_cast<unsigned>(run.number("threads"));
+              size_t edges = 0;
+              run.measure([&] {
+                CsrGraph graph = loadDimacs(run.param("dimacs"), threads);
+                edges = graph.edgeCount();
+              });
+              run.setItems(static_cast<double>(edges));
+            });
+
+  // converts the DIMACS graph to "<dimacs>.csr" once and maps the snapshot
+  suite.add("load/snapshot", {{"dimacs", {}}},
+            [](BenchmarkRun &run) {
+              const string snapshot = run.param("dimacs") + ".csr";
+              convertDimacsToSnapshot(run.param("dimacs"), snapshot);
+              size_t edges = 0;
+              run.measure([&] {
+                CsrGraph graph = loadSnapshot(snapshot);
+                edges = graph.edgeCount();
+              });
+              run.setItems(static_cast<double>(edges));
+            });
+
+  suite.add("query/bidirectional",
+            {{"side", {"1000"}},
+             {"queries", {"100"}},
+             {"method", {"bidirectional", "single_source"}}},
+            [](BenchmarkRun &run) {
+              CsrGraph graph =
+                  generateGrid(run.number("side"), run.number("side"), 50,
+                               0.1f, 42)
+                      .toCsr();
+              CsrGraph reversed = graph.reversed();
+              const size_t queries = run.number("queries");
+              vector<unsigned> from = randomVertices(graph.size(), queries, 1);
+              vector<unsigned> to = randomVertices(graph.size(), queries, 2);
+              const bool bidirectional = run.param("method") == "bidirectional";
+              size_t settled = 0;
+              run.setItems(static_cast<double>(queries));
+              run.measure([&] {
+                settled = 0;
+                for (size_t i = 0; i < queries; ++i) {
+                  if (bidirectional) {
+                    PathQueryResult result =
+                        shortestPathBidirectional(graph, reversed, from[i],
+                                                  to[i]);
+                    settled += result.settled;
+                  } else {
+                    vector<unsigned> distances =
+                        graph.shortestPathFibHeap(from[i], false, false);
+                    doNotOptimize(distances[to[i]]);
+                  }
+                }
+              });
+              if (bidirectional)
+                run.counter("settled/query",
+                            static_cast<double>(settled) / queries);
+            });
+
+  suite.add(
+      "query/astar",
+      {{"graph", {"geometric", "grid"}},
+       {"vertices", {"1000000"}},
+       {"queries", {"100"}},
+       {"heuristic", {"none", "coordinates", "landmarks"}}},
+      [](BenchmarkRun &run) {
+        // coordinates are Euclidean on geometric and Manhattan on grid graphs
+        const size_t vertices = run.number("vertices");
+        const size_t side = static_cast<size_t>(sqrt(vertices));
+        const double scale = 10000;
+        const bool geometric = run.param("graph") == "geometric";
+        GeneratedGraph generated =
+            geometric ? generateGeometric(vertices, 8, scale, 42)
+                      : generateGrid(side, side, 50, 0.1f, 42);
+        CsrGraph graph = generated.toCsr();
+        const vector<Point> &coordinates = generated.coordinates;
+        const size_t queries = run.number("queries");
+        vector<unsigned> from = randomVertices(graph.size(), queries, 1);
+        vector<unsigned> to = randomVertices(graph.size(), queries, 2);
+        optional<Landmarks> landmarks;
+        if (run.param("heuristic") == "landmarks")
+          landmarks.emplace(graph, graph.reversed(), 8);
+
+        size_t settled = 0;
+        auto measure = [&](auto makeHeuristic) {
+          run.measure([&] {
+            settled = 0;
+            for (size_t i = 0; i < queries; ++i) {
+              PathQueryResult result = shortestPathAStar(
+                  graph, from[i], to[i], makeHeuristic(to[i]));
+              settled += result.settled;
+            }
+          });
+        };
+        run.setItems(static_cast<double>(queries));
+        if (run.param("heuristic") == "none") {
+          measure([](unsigned) { return ZeroHeuristic(); });
+        } else if (landmarks) {
+          measure([&](unsigned t) { return LandmarkHeuristic(*landmarks, t); });
+        } else if (geometric) {
+          measure([&](unsigned t) {
+            return EuclideanHeuristic(coordinates, t, scale);
+          });
+        } else {
+          measure([&](unsigned t) {
+            return ManhattanHeuristic(coordinates, t, 1);
+          });
+        }
+        run.counter("settled/query", static_cast<double>(settled) / queries);
+      });
+
+  suite.add("query/nearest_facility",
+            {{"side", {"1000"}},
+             {"facilities", {"100"}},
+             {"queries", {"100"}},
+             {"method", {"bounded", "full"}}},
+            [](BenchmarkRun &run) {
+              // bounded stops at the first settled facility
+              CsrGraph graph =
+                  generateGrid(run.number("side"), run.number("side"), 50,
+                               0.1f, 42)
+                      .toCsr();
+              DijkstraOptions options;
+              options.targets =
+                  randomVertices(graph.size(), run.number("facilities"), 1);
+              options.targetCount = 1;
+              const size_t queries = run.number("queries");
+              vector<unsigned> from = randomVertices(graph.size(), queries, 2);
+              const bool bounded = run.param("method") == "bounded";
+              size_t settled = 0;
+              run.setItems(static_cast<double>(queries));
+              run.measure([&] {
+                settled = 0;
+                for (unsigned source : from) {
+                  if (bounded) {
+                    DijkstraResult result =
+                        shortestPathBounded(graph, source, options);
+                    settled += result.settled.size();
+                  } else {
+                    vector<unsigned> distances =
+                        graph.shortestPathFibHeap(source, false, false);
+                    unsigned nearest = MY_MAX;
+                    for (unsigned facility : options.targets)
+                      nearest = min(nearest, distances[facility]);
+                    doNotOptimize(nearest);
+                  }
+                }
+              });
+              if (bounded)
+                run.counter("settled/query",
+                            static_cast<double>(settled) / queries);
+            });
+
+  suite.add("query/workspace",
+            {{"side", {"1000"}},
+             {"queries", {"10000"}},
+             {"max_settled", {"1000"}},
+             {"workspace", {"reused", "fresh"}}},
+            [](BenchmarkRun &run) {
+              // fresh allocates buffers of the whole graph for every query
+              CsrGraph graph =
+                  generateGrid(run.number("side"), run.number("side"), 50,
+                               0.1f, 42)
+                      .toCsr();
+              DijkstraOptions options;
+              options.maxSettled = run.number("max_settled");
+              const size_t queries = run.number("queries");
+              vector<unsigned> from = randomVertices(graph.size(), queries, 1);
+              const bool reused = run.param("workspace") == "reused";
+              DijkstraWorkspace workspace;
+              run.setItems(static_cast<double>(queries));
+              run.measure([&] {
+                for (unsigned source : from) {
+                  if (reused) {
+                    workspace.run(graph, source, options);
+                    doNotOptimize(workspace.settled().size());
+                  } else {
+                    DijkstraResult result =
+                        shortestPathBounded(graph, source, options);
+                    doNotOptimize(result.settled.size());
+                  }
+                }
+              });
+            });
+
+  suite.add("multi_source",
+            {{"side", {"1000"}},
+             {"sources", {"50"}},
+             {"method", {"multi_source", "loop"}}},
+            [](BenchmarkRun &run) {
+              // distance to the nearest source from every vertex, loop runs
+              // Dijkstra from every source
+              CsrGraph graph =
+                  generateGrid(run.number("side"), run.number("side"), 50,
+                               0.1f, 42)
+                      .toCsr();
+              vector<unsigned> sources =
+                  randomVertices(graph.size(), run.number("sources"), 1);
+              const bool multi = run.param("method") == "multi_source";
+              DijkstraWorkspace workspace;
+              run.setItems(static_cast<double>(graph.edgeCount()));
+              run.measure([&] {
+                if (multi) {
+                  workspace.run(graph, sources);
+                  doNotOptimize(workspace.settled().size());
+                  return;
+                }
+                vector<unsigned> nearest(graph.size(), MY_MAX);
+                for (unsigned source : sources) {
+                  vector<unsigned> distances =
+                      graph.shortestPathFibHeap(source, false, false);
+                  for (size_t v = 0; v < graph.size(); ++v)
+                    nearest[v] = min(nearest[v], distances[v]);
+                }
+                doNotOptimize(nearest.data());
+              });
+            });
+
+  suite.add("distance_table",
+            {{"side", {"1000"}},
+             {"sources", {"50"}},
+             {"threads", {"0", "1", "2", "4"}}},
+            [](BenchmarkRun &run) {
+              // 0 threads means a sequential loop of bounded queries
+              CsrGraph graph =
+                  generateGrid(run.number("side"), run.number("side"), 50,
+                               0.1f, 42)
+                      .toCsr();
+              vector<unsigned> sources =
+                  randomVertices(graph.size(), run.number("sources"), 1);
+              unsigned threads = static_cast<unsigned>(run.number("threads"));
+              optional<ThreadPool> pool;
+              if (threads)
+                pool.emplace(threads);
+              DijkstraOptions options;
+              options.targets = sources;
+              run.setItems(static_cast<double>(sources.size()));
+              run.measure([&] {
+                if (threads) {
+                  vector<vector<unsigned>> table =
+                      distanceTable(graph, sources, sources, *pool);
+                  doNotOptimize(table.data());
+                  return;
+                }
+                for (unsigned source : sources) {
+                  DijkstraResult result =
+                      shortestPathBounded(graph, source, options);
+                  doNotOptimize(result.distances.data());
+                }
+              });
+            });
+
+  suite.add("mst/prim",
+            {{"vertices", {"1000000"}},
+             {"engine", {"fibheap", "priority_queue"}}},
+            [](BenchmarkRun &run) {
+              CsrGraph graph = generateGraph("geometric", run.number("vertices"));
+              run.setItems(static_cast<double>(graph.edgeCount()));
+              size_t decreases = 0;
+              auto prim = [&](auto &engine) {
+                run.measure([&] {
+                  SpanningTree tree = minimumSpanningTree(graph, engine);
+                  doNotOptimize(tree.weight);
+                  decreases = engine.decreases();
+                });
+              };
+              if (run.param("engine") == "fibheap") {
+                FibHeapEngine<unsigned> engine;
+                prim(engine);
+              } else {
+                LazyQueueEngine<unsigned> engine;
+                prim(engine);
+              }
+              run.counter("decreases", static_cast<double>(decreases));
+            });
+
+  suite.add("mincut/stoer_wagner",
+            {{"vertices", {"500"}}, {"engine", {"fibheap", "priority_queue"}}},
+            [](BenchmarkRun &run) {
+              CsrGraph graph = generateGraph("random", run.number("vertices"));
+              run.setItems(static_cast<double>(graph.edgeCount()));
+              auto cut = [&](auto &engine) {
+                run.measure([&] {
+                  MinimumCut result = minimumCut(graph, engine);
+                  doNotOptimize(result.weight);
+                });
+              };
+              if (run.param("engine") == "fibheap") {
+                FibHeapEngine<long long> engine;
+                cut(engine);
+              } else {
+                LazyQueueEngine<long long> engine;
+                cut(engine);
+              }
+            });
+
+  suite.add("workload",
+            {{"mix", {"hold", "sorting", "decrease", "delete", "merge"}},
+             {"keys",
+              {"uniform", "exponential", "sorted", "reverse", "duplicates"}},
+             {"size", {"100000"}},
+             {"operations", {"1000000"}},
+             {"engine", {"fibheap", "priority_queue"}}},
+            [](BenchmarkRun &run) {
+              Workload workload = generateWorkload(
+                  run.param("mix"), run.param("keys"), run.number("size"),
+                  run.number("operations"), 42);
+              run.setItems(static_cast<double>(workload.operations.size()));
+              unsigned long long checksum = 0;
+              auto measure = [&](auto &engine) {
+                run.measure([&] { checksum = runWorkload(engine, workload); });
+              };
+              if (run.param("engine") == "fibheap") {
+                FibHeapEngine<unsigned long long> engine;
+                measure(engine);
+#ifdef FIBHEAP_STATS
+                // operations of one more run, outside of the measurement
+                engine.resetStats();
+                runWorkload(engine, workload);
+                const FibHeapStats stats = engine.stats();
+                const double items =
+                    static_cast<double>(workload.operations.size());
+                run.counter("links/op", static_cast<double>(stats.links) / items);
+                run.counter("cuts/op", static_cast<double>(stats.cuts) / items);
+                run.counter("cascading_cuts/op",
+                            static_cast<double>(stats.cascadingCuts) / items);
+                run.counter("comparisons/op",
+                            static_cast<double>(stats.comparisons) / items);
+                run.counter("peak_roots", static_cast<double>(stats.peakRoots));
+                run.counter("max_degree", stats.maxDegree);
+#endif
+              } else {
+                LazyQueueEngine<unsigned long long> engine;
+                measure(engine);
+              }
+              // equal for all engines of the same workload
+              run.counter("checksum", static_cast<double>(checksum % 1000000));
+            });
+
+  // replays a trace recorded by TracingFibHeap, runs only with a trace given,
+  // e.g. pv264_bench --filter replay --set trace=production.trace
+  suite.add("replay",
+            {{"trace", {}},
+             {"engine", {"fibheap", "priority_queue"}}},
+            [](BenchmarkRun &run) {
+              Workload trace = loadTrace(run.param("trace"));
+              run.setItems(static_cast<double>(trace.operations.size()));
+              unsigned long long checksum = 0;
+              auto measure = [&](auto &engine) {
+                run.measure([&] { checksum = runWorkload(engine, trace); });
+              };
+              if (run.param("engine") == "fibheap") {
+                FibHeapEngine<unsigned long long> engine;
+                measure(engine);
+              } else {
+                LazyQueueEngine<unsigned long long> engine;
+                measure(engine);
+              }
+              run.counter("checksum", static_cast<double>(checksum % 1000000));
+            });
+
+  suite.add(
+      "latency/mixed",
+      {{"size", {"10000", "1000000"}},
+       {"mix", {"dijkstra", "scheduler"}},
+       {"operations", {"1000000"}}},
+      [](BenchmarkRun &run) {
+        using Heap = FibHeap<LatencyItem, cmpLatencyItem>;
+        // insert, extract_top, increase_key, delete_value
+        const unsigned dijkstra[4] = {30, 30, 40, 0};
+        const unsigned scheduler[4] = {50, 35, 5, 10};
+        const unsigned(&percent)[4] =
+            run.param("mix") == "dijkstra" ? dijkstra : scheduler;
+        const size_t size = run.number("size");
+        const size_t operations = run.number("operations");
+
+        vector<optional<Heap::Handler>> handlers;
+        vector<unsigned> live;
+        Heap heap;
+        TimedFibHeap<LatencyItem, cmpLatencyItem> timed(heap);
+        mt19937_64 generator(42);
+        unsigned setups = 0;
+        run.setItems(static_cast<double>(operations));
+        run.measure(
+            [&] {
+              // the histograms keep only the timed repetitions
+              if (setups++ == run.warmup())
+                timed.clear();
+              heap = Heap();
+              handlers.clear();
+              live.clear();
+              for (unsigned slot = 0; slot < size; ++slot) {
+                handlers.emplace_back(
+                    heap.insert(LatencyItem{generator(), slot}));
+                live.push_back(slot);
+              }
+              // consolidates the prefilled root list outside of the
+              // measured sequence
+              unsigned slot = heap.top().slot;
+              heap.extract_top();
+              handlers[slot].reset();
+              live.erase(find(live.begin(), live.end(), slot));
+            },
+            [&] {
+              mixedOperations(timed, handlers, live, percent, operations,
+                              generator);
+            });
+
+        const pair<const char *, const LatencyHistogram *> histograms[] = {
+            {"insert", &timed.inserts()},
+            {"extract_top", &timed.extracts()},
+            {"increase_key", &timed.increases()},
+            {"delete_value", &timed.deletes()}};
+        for (const auto &histogram : histograms) {
+          if (histogram.second->count() == 0)
+            continue;
+          string name = histogram.first;
+          run.counter(name + "_p50_ns",
+                      static_cast<double>(histogram.second->percentile(50)));
+          run.counter(name + "_p99_ns",
+                      static_cast<double>(histogram.second->percentile(99)));
+          run.counter(name + "_p99.9_ns",
+                      static_cast<double>(histogram.second->percentile(99.9)));
+          run.counter(name + "_max_ns",
+                      static_cast<double>(histogram.second->max()));
+        }
+      });
+
+  suite.add("scheduler/priority",
+            {{"bulk", {"10000"}}, {"urgent", {"100"}}, {"threads", {"4"}}},
+            [](BenchmarkRun &run) {
+              // bulk coroutines (priority 0) are scheduled before the urgent
+              // ones (priority 1), a FIFO executor would run the urgent last
+              const size_t bulk = run.number("bulk");
+              const size_t urgent = run.number("urgent");
+              vector<int> order;
+              mutex orderMutex;
+              run.setItems(static_cast<double>(bulk + urgent));
+              run.measure([&] {
+                order.clear();
+                PriorityScheduler scheduler(
+                    static_cast<unsigned>(run.number("threads")));
+                for (size_t i = 0; i < bulk; ++i)
+                  scheduledJob(scheduler, 0, nullptr, 100000, order,
+                               orderMutex);
+                for (size_t i = 0; i < urgent; ++i)
+                  scheduledJob(scheduler, 1, nullptr, 100000, order,
+                               orderMutex);
+                scheduler.shutdown();
+              });
+              double position = 0;
+              for (size_t i = 0; i < order.size(); ++i) {
+                if (order[i] == 1)
+                  position += static_cast<double>(i) / order.size();
+              }
+              run.counter("urgent_position",
+                          urgent ? position / urgent : 0);
+            });
+
+  suite.add("task_pool/skewed",
+            {{"tasks", {"100000"}},
+             {"work", {"10000"}},
+             {"threads", {"8"}},
+             {"stealing", {"off", "on"}}},
+            [](BenchmarkRun &run) {
+              // one task on worker 0 spawns all the others, without stealing
+              // worker 0 runs all of them
+              const size_t tasks = run.number("tasks");
+              const size_t work = run.number("work");
+              size_t steals = 0;
+              run.setItems(static_cast<double>(tasks));
+              run.measure([&] {
+                WorkStealingPool pool(
+                    static_cast<unsigned>(run.number("threads")),
+                    run.param("stealing") == "on");
+                pool.submit(0u, 0, [&]() {
+                  mt19937 generator(42);
+                  for (size_t i = 0; i < tasks; ++i) {
+                    pool.submit(static_cast<int>(generator() % 100), [&]() {
+                      volatile size_t sink = 0;
+                      for (size_t j = 0; j < work; ++j)
+                        sink = sink + j;
+                    });
+                  }
+                });
+                pool.wait();
+                steals = pool.steals();
+              });
+              run.counter("steals", static_cast<double>(steals));
+            });
+
+  suite.add("memory",
+            {{"size", {"1000", "100000", "1000000"}},
+             {"payload", {"int", "string"}},
+             {"engine",
+              {"fibheap", "priority_queue", "fibheap_engine", "lazy_queue"}}},
+            [](BenchmarkRun &run) {
+              if (run.param("payload") == "int")
+                measureMemory(run, randomIntegers(run.number("size")));
+              else
+                measureMemory(run, randomStrings(run.number("size")));
+            });
+
+  // sizes up to 10^9 are possible with --set size=..., FibHeap with Handlers
+  // needs about 100 bytes per item
+  const vector<CacheLevel> caches = cacheLevels();
+  suite.add("scalability",
+            {{"size", {"1000", "10000", "100000", "1000000", "10000000"}},
+             {"operation", {"insert", "extract", "decrease"}},
+             {"engine", {"fibheap", "priority_queue"}}},
+            [&caches](BenchmarkRun &run) {
+              measureScalability(run, run.number("size"), caches);
+            });
+
+  return suite.main(argc, argv);
+}
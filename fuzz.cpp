@@ -0,0 +1,340 @@
+#include "FibHeap.hpp"
+#include "HeapEngines.hpp"
+#include "Trace.hpp"
+#include "Workload.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Differential fuzz target
+ * decodes bytes into a sequence of heap operations and applies it at once to
+ * FibHeap, a std::set model, the engines of HeapEngines.hpp and
+ * TracingFibHeap, the tops, sizes and popped items have to be the same
+ * FibHeap additionally checks its invariants by validate after every
+ * operation and the recorded trace has to replay to the same pops
+ *
+ * built with libFuzzer (clang, FIBHEAP_LIBFUZZER) it only defines
+ * LLVMFuzzerTestOneInput, otherwise main runs the inputs given as files
+ * (or standard input, for AFL) or --random N generated inputs
+ */
+
+/**
+ * prints the violated condition and aborts, so fuzzers record the input
+ */
+#define FUZZ_CHECK(condition)                                                  \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,    \
+                   #condition);                                                \
+      std::abort();                                                            \
+    }                                                                          \
+  } while (false)
+
+/**
+ * single decoded operation
+ * Insert adds item @id with @key, Extract pops the top, Increase lowers the
+ * key of the @select-th item by @key, Delete removes the @select-th item,
+ * Unite melds a heap of items @id .. @id + @count - 1, Copy checks copies of
+ * FibHeap, Move moves FibHeap back and forth, Split detaches a tree and
+ * unites it back
+ */
+struct FuzzOperation {
+  enum Type : unsigned char {
+    Insert,
+    Extract,
+    Increase,
+    Delete,
+    Unite,
+    Copy,
+    Move,
+    Split
+  };
+
+  Type type;
+  unsigned id;
+  unsigned select;
+  unsigned long long key;
+  unsigned count;
+};
+
+/**
+ * decoded input
+ * keys holds the initial key of every item (indexed by id)
+ */
+struct FuzzProgram {
+  FuzzProgram() : operations(), keys() {}
+
+  std::vector<FuzzOperation> operations;
+  std::vector<unsigned long long> keys;
+};
+
+/**
+ * every operation takes one byte of type and up to three bytes of
+ * arguments, missing bytes are zeros, keys are 16-bit (so ties are common)
+ * @param data input bytes
+ * @param size number of bytes
+ * @return decoded program of at most 2048 operations
+ */
+FuzzProgram decode(const uint8_t *data, size_t size) {
+  FuzzProgram program;
+  size_t position = 0;
+  auto byte = [&]() -> unsigned {
+    return position < size ? data[position++] : 0;
+  };
+  auto key = [&]() -> unsigned long long {
+    unsigned high = byte();
+    return high << 8 | byte();
+  };
+
+  while (position < size && program.operations.size() < 2048) {
+    FuzzOperation operation{
+        static_cast<FuzzOperation::Type>(byte() % (FuzzOperation::Split + 1)),
+        0, 0, 0, 0};
+    switch (operation.type) {
+    case FuzzOperation::Insert:
+      operation.id = static_cast<unsigned>(program.keys.size());
+      operation.key = key();
+      program.keys.push_back(operation.key);
+      break;
+    case FuzzOperation::Increase:
+      operation.select = byte();
+      operation.key = key();
+      break;
+    case FuzzOperation::Delete:
+      operation.select = byte();
+      break;
+    case FuzzOperation::Unite:
+      operation.id = static_cast<unsigned>(program.keys.size());
+      operation.count = byte() % 8 + 1;
+      for (unsigned i = 0; i < operation.count; ++i)
+        program.keys.push_back(key());
+      break;
+    default:
+      break;
+    }
+    program.operations.push_back(operation);
+  }
+  return program;
+}
+
+/**
+ * runs @program on all engines and checks them against the model
+ */
+void execute(const FuzzProgram &program) {
+  using Entry = EngineEntry<unsigned long long>;
+  using Heap = FibHeap<Entry, cmpEngineEntry<unsigned long long>>;
+  const size_t items = program.keys.size();
+
+  // model: (current key, id) of items in the heap
+  std::set<std::pair<unsigned long long, unsigned>> model;
+  std::vector<unsigned long long> current(program.keys);
+
+  std::vector<std::optional<Heap::Handler>> handlers(items);
+  Heap heap;
+  FibHeapEngine<unsigned long long> fibEngine;
+  LazyQueueEngine<unsigned long long> lazyEngine;
+  TracingFibHeap<Entry, cmpEngineEntry<unsigned long long>> traced(
+      [](const Entry &entry) { return entry.key; });
+  fibEngine.reset(items);
+  lazyEngine.reset(items);
+  unsigned long long checksum = 0;
+
+  auto check = [&] {
+    heap.validate();
+    FUZZ_CHECK(heap.size() == model.size());
+    FUZZ_CHECK(traced.size() == model.size());
+    FUZZ_CHECK(fibEngine.empty() == model.empty());
+    FUZZ_CHECK(lazyEngine.empty() == model.empty());
+    if (model.empty())
+      return;
+    const unsigned long long key = model.begin()->first;
+    const unsigned id = model.begin()->second;
+    FUZZ_CHECK(heap.top().id == id && heap.top().key == key);
+    FUZZ_CHECK(traced.top().id == id);
+    FUZZ_CHECK(fibEngine.top() == id && fibEngine.topKey() == key);
+    FUZZ_CHECK(lazyEngine.top() == id && lazyEngine.topKey() == key);
+  };
+  auto insert = [&](Heap &target, unsigned id) {
+    const unsigned long long key = program.keys[id];
+    handlers[id].emplace(target.insert(Entry{key, id}));
+    model.emplace(key, id);
+  };
+  auto pop = [&] {
+    const unsigned id = model.begin()->second;
+    heap.extract_top();
+    handlers[id].reset();
+    traced.extract_top();
+    fibEngine.pop();
+    lazyEngine.pop();
+    model.erase(model.begin());
+    checksum = checksum * 1000003 + id;
+  };
+  // the model is ordered, so the selection is the same for all engines
+  auto select = [&](unsigned select) {
+    return std::next(model.begin(), select % model.size())->second;
+  };
+  // every copy has to contain the same items in the same order
+  auto checkCopy = [&](Heap &copy) {
+    copy.validate();
+    FUZZ_CHECK(copy.size() == model.size());
+    for (const auto &item : model) {
+      FUZZ_CHECK(copy.top().id == item.second);
+      copy.extract_top();
+    }
+    FUZZ_CHECK(copy.empty());
+  };
+
+  for (const FuzzOperation &operation : program.operations) {
+    switch (operation.type) {
+    case FuzzOperation::Insert:
+      insert(heap, operation.id);
+      FUZZ_CHECK(fibEngine.offer(operation.id, operation.key));
+      FUZZ_CHECK(lazyEngine.offer(operation.id, operation.key));
+      traced.insert(Entry{operation.key, operation.id});
+      break;
+    case FuzzOperation::Extract:
+      if (!model.empty())
+        pop();
+      break;
+    case FuzzOperation::Increase: {
+      if (model.empty())
+        break;
+      const unsigned id = select(operation.select);
+      // strictly lower key, increase_key rejects equal values
+      const unsigned long long key =
+          current[id] - std::min(current[id], operation.key + 1);
+      if (key == current[id])
+        break;
+      model.erase(std::make_pair(current[id], id));
+      model.emplace(key, id);
+      current[id] = key;
+      heap.increase_key(*handlers[id], Entry{key, id});
+      FUZZ_CHECK(fibEngine.offer(id, key));
+      FUZZ_CHECK(lazyEngine.offer(id, key));
+      traced.increase_key(id, Entry{key, id});
+      break;
+    }
+    case FuzzOperation::Delete: {
+      if (model.empty())
+        break;
+      const unsigned id = select(operation.select);
+      model.erase(std::make_pair(current[id], id));
+      heap.delete_value(*handlers[id]);
+      handlers[id].reset();
+      fibEngine.erase(id);
+      lazyEngine.erase(id);
+      traced.delete_value(id);
+      break;
+    }
+    case FuzzOperation::Unite: {
+      Heap other;
+      std::vector<Entry> values;
+      for (unsigned id = operation.id; id < operation.id + operation.count;
+           ++id) {
+        insert(other, id);
+        values.push_back(Entry{program.keys[id], id});
+      }
+      other.validate();
+      heap.uniteWith(other);
+      FUZZ_CHECK(other.empty());
+      fibEngine.merge(operation.id, operation.count, program.keys.data());
+      lazyEngine.merge(operation.id, operation.count, program.keys.data());
+      traced.merge(values);
+      break;
+    }
+    case FuzzOperation::Copy: {
+      Heap copy(heap);
+      checkCopy(copy);
+      Heap assigned;
+      assigned = heap;
+      checkCopy(assigned);
+      break;
+    }
+    case FuzzOperation::Move: {
+      // Handlers stay valid, the Nodes do not move
+      Heap moved(std::move(heap));
+      FUZZ_CHECK(heap.empty());
+      heap = std::move(moved);
+      FUZZ_CHECK(moved.empty());
+      break;
+    }
+    case FuzzOperation::Split: {
+      Heap part = heap.splitTree();
+      part.validate();
+      FUZZ_CHECK(part.size() + heap.size() == model.size());
+      heap.uniteWith(part);
+      break;
+    }
+    }
+    check();
+  }
+
+  while (!model.empty()) {
+    pop();
+    check();
+  }
+
+  // the trace replays to the same sequence of pops
+  std::stringstream stream;
+  writeTrace(stream, traced.trace());
+  Workload trace = readTrace(stream);
+  FUZZ_CHECK(runWorkload(fibEngine, trace) == checksum);
+  FUZZ_CHECK(runWorkload(lazyEngine, trace) == checksum);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  execute(decode(data, size));
+  return 0;
+}
+
+#ifndef FIBHEAP_LIBFUZZER
+
+/**
+ * runs the target on files given as arguments, on standard input without
+ * arguments, or on N random inputs with --random N
+ */
+int main(int argc, char **argv) {
+  auto run = [](std::istream &in) {
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+  };
+
+  if (argc == 1) {
+    run(std::cin);
+    return 0;
+  }
+  if (std::string(argv[1]) == "--random") {
+    const unsigned long count = argc > 2 ? std::stoul(argv[2]) : 1000;
+    std::mt19937 generator(42);
+    for (unsigned long i = 0; i < count; ++i) {
+      std::vector<uint8_t> data(generator() % 4096);
+      for (uint8_t &byte : data)
+        byte = static_cast<uint8_t>(generator());
+      LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    return 0;
+  }
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    if (!file.is_open()) {
+      std::cerr << "Cannot open file " << argv[i] << "!" << std::endl;
+      return 1;
+    }
+    run(file);
+  }
+  return 0;
+}
+
+#endif
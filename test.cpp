@@ -1,6 +1,27 @@
 #include "FibHeap.hpp"
+#include "Graph.hpp"
+#include "GraphAlgorithms.hpp"
+#include "GraphGenerators.hpp"
+#include "GraphLoader.hpp"
+#include "GraphSnapshot.hpp"
+#include "LatencyHistogram.hpp"
+#include "PathQueries.hpp"
+#include "PriorityScheduler.hpp"
+#include "TaskPool.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include "Workload.hpp"
 #include "catch.hpp"
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <set>
 
 #define CATCH_CONFIG_MAIN
 
@@ -238,6 +259,88 @@ TEST_CASE("Simple range constructor") { // NOLINT
   REQUIRE(nEmptyHeap.size() == 1);
 }
 
+TEST_CASE("Parallel range constructor") { // NOLINT
+  std::vector<int> emptyVector;
+  std::vector<int> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back((i * 7919) % 1000);
+  }
+
+  FibHeap<int> emptyHeap(emptyVector.begin(), emptyVector.end(), 4);
+  REQUIRE(emptyHeap.empty());
+
+  FibHeap<int> smallHeap(values.begin(), values.begin() + 3, 8);
+  REQUIRE(smallHeap.size() == 3);
+  REQUIRE(smallHeap.top() == *std::max_element(values.begin(),
+                                               values.begin() + 3));
+
+  for (unsigned threads : {1u, 2u, 3u, 7u}) {
+    FibHeap<int> testHeap(values.begin(), values.end(), threads);
+    REQUIRE(testHeap.size() == values.size());
+    std::vector<int> copy = values;
+    REQUIRE(CheckHeap(testHeap, copy));
+  }
+}
+
+TEST_CASE("Parallel consolidation") { // NOLINT
+  std::vector<int> values;
+  for (int i = 0; i < 5000; ++i) {
+    values.push_back((i * 7919) % 2500);
+  }
+
+  for (unsigned threads : {2u, 3u, 8u}) {
+    std::vector<FibHeap<int>::Handler> handlers;
+    FibHeap<int> testHeap;
+    testHeap.setParallelConsolidation(16, threads);
+    for (int value : values) {
+      handlers.push_back(testHeap.insert(value));
+    }
+    testHeap.increase_key(handlers[10], 3000);
+    REQUIRE(testHeap.top() == 3000);
+    testHeap.extract_top();
+    REQUIRE(testHeap.top() == 2499);
+
+    FibHeap<int> copiedHeap(testHeap);
+    std::vector<int> rest(values.begin(), values.end());
+    rest.erase(rest.begin() + 10);
+    REQUIRE(CheckHeap(testHeap, rest));
+    REQUIRE(copiedHeap.size() == values.size() - 1);
+  }
+}
+
+TEST_CASE("Split tree test") { // NOLINT
+  FibHeap<int> singleHeap{1};
+  REQUIRE(singleHeap.splitTree().empty());
+  REQUIRE(singleHeap.size() == 1);
+
+  std::vector<FibHeap<int>::Handler> handlers;
+  FibHeap<int> testHeap;
+  for (int i = 0; i < 100; ++i) {
+    handlers.push_back(testHeap.insert(i));
+  }
+  testHeap.extract_top();
+
+  FibHeap<int> stolen;
+  while (testHeap.size() > 1) {
+    FibHeap<int> tree = testHeap.splitTree();
+    REQUIRE(!tree.empty());
+    REQUIRE(testHeap.top() == 98);
+    stolen.uniteWith(tree);
+  }
+  REQUIRE(stolen.size() == 98);
+
+  testHeap.increase_key(handlers[98], 200);
+  stolen.increase_key(handlers[5], 300);
+  REQUIRE(testHeap.top() == 200);
+  REQUIRE(stolen.top() == 300);
+
+  std::vector<int> values;
+  for (int i = 0; i < 98; ++i) {
+    values.push_back(i == 5 ? 300 : i);
+  }
+  REQUIRE(CheckHeap(stolen, values));
+}
+
 TEST_CASE("Simple initializer list constructor test") { // NOLINT
   FibHeap<int> testHeap{1, 3, 9, 5, 0, 8};
   REQUIRE(testHeap.top() == 9);
@@ -706,3 +809,1143 @@ TEST_CASE("Test") { // NOLINT
   testHeap3.delete_value(H100);
   testHeap1.swap(testHeap3);
 }
+
+#ifdef FIBHEAP_STATS
+TEST_CASE("Statistics test") { // NOLINT
+  std::vector<FibHeap<int>::Handler> handlers;
+  FibHeap<int> fibHeap;
+  for (int i = 1; i <= 8; ++i)
+    handlers.push_back(fibHeap.insert(i));
+  REQUIRE(fibHeap.stats().allocations == 8);
+  REQUIRE(fibHeap.stats().peakRoots == 8);
+  REQUIRE(fibHeap.stats().links == 0);
+
+  fibHeap.extract_top();
+  // 7 roots are linked into trees of sizes 4, 2 and 1
+  REQUIRE(fibHeap.stats().links == 4);
+  REQUIRE(fibHeap.stats().maxDegree == 2);
+  REQUIRE(fibHeap.stats().deallocations == 1);
+  REQUIRE(fibHeap.stats().comparisons > 0);
+
+  for (int i = 0; i < 7; ++i)
+    fibHeap.increase_key(handlers[i], 100 + i);
+  REQUIRE(fibHeap.stats().cuts > 0);
+  REQUIRE(fibHeap.stats().cuts >= fibHeap.stats().cascadingCuts);
+  REQUIRE(fibHeap.top() == 106);
+
+  fibHeap.resetStats();
+  REQUIRE(fibHeap.stats().comparisons == 0);
+  REQUIRE(fibHeap.stats().allocations == 0);
+}
+#else
+TEST_CASE("Statistics test") { // NOLINT
+  // without FIBHEAP_STATS the counting is compiled out
+  FibHeap<int> fibHeap{1, 2, 3};
+  fibHeap.extract_top();
+  REQUIRE(fibHeap.stats().links == 0);
+  REQUIRE(fibHeap.stats().allocations == 0);
+}
+#endif
+
+TEST_CASE("Memory usage test") { // NOLINT
+  FibHeap<int> fibHeap;
+  REQUIRE(fibHeap.memory_usage().total() == 0);
+  for (int i = 0; i < 100; ++i)
+    fibHeap.insert(i);
+  FibHeapMemory memory = fibHeap.memory_usage();
+  REQUIRE(memory.nodes > 0);
+  REQUIRE(memory.nodes % 100 == 0);
+  REQUIRE(memory.payload == 0);
+  REQUIRE(memory.scratch > 0);
+
+  fibHeap.extract_top();
+  fibHeap.extract_top();
+  // every Node of the consolidated trees is visited once
+  memory = fibHeap.memory_usage([](int) { return size_t(1); });
+  REQUIRE(memory.payload == 98);
+  REQUIRE(memory.total() ==
+          memory.nodes + memory.payload + memory.allocatorSlack +
+              memory.scratch);
+}
+
+TEST_CASE("Validate test") { // NOLINT
+  std::mt19937 generator(42);
+  std::vector<std::optional<FibHeap<int>::Handler>> handlers;
+  FibHeap<int> fibHeap;
+  REQUIRE_NOTHROW(fibHeap.validate());
+  for (int i = 0; i < 2000; ++i) {
+    unsigned roll = generator() % 10;
+    if (roll < 4 || fibHeap.empty()) {
+      handlers.emplace_back(
+          fibHeap.insert(static_cast<int>(generator() % 1000)));
+    } else if (roll < 6) {
+      fibHeap.extract_top();
+    } else {
+      auto &handler = handlers[generator() % handlers.size()];
+      if (!handler || !handler->isValid())
+        continue;
+      if (roll < 9)
+        fibHeap.increase_key(*handler, handler->value() + 1000);
+      else
+        fibHeap.delete_value(*handler);
+    }
+    REQUIRE_NOTHROW(fibHeap.validate());
+  }
+
+  FibHeap<int> other{5, 3, 8, 1};
+  other.extract_top();
+  fibHeap.uniteWith(other);
+  REQUIRE_NOTHROW(fibHeap.validate());
+  REQUIRE_NOTHROW(other.validate());
+  FibHeap<int> split = fibHeap.splitTree();
+  REQUIRE_NOTHROW(fibHeap.validate());
+  REQUIRE_NOTHROW(split.validate());
+}
+
+/**
+ * Coroutine which starts immediately and destroys itself when finished
+ */
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+/**
+ * occupies the worker of @scheduler until @release is set
+ */
+DetachedTask blockWorker(PriorityScheduler &scheduler,
+                         std::promise<void> &started,
+                         std::shared_future<void> release) {
+  co_await scheduler.schedule(100);
+  started.set_value();
+  release.wait();
+}
+
+/**
+ * records @id when resumed (by the only worker)
+ */
+DetachedTask recordResume(PriorityScheduler &scheduler, int priority,
+                          PriorityScheduler::Ticket *ticket, int id,
+                          std::vector<int> &order) {
+  co_await scheduler.schedule(priority, ticket);
+  order.push_back(id);
+}
+
+TEST_CASE("Priority scheduler test") { // NOLINT
+  std::vector<int> order;
+  std::promise<void> started, release;
+  PriorityScheduler::Ticket ticket = 0;
+  PriorityScheduler scheduler(1);
+  blockWorker(scheduler, started, release.get_future().share());
+  started.get_future().wait();
+
+  // coroutines 1 and 3 have the same priority, so they keep FIFO order
+  const int priorities[] = {1, 3, 2, 3, 1};
+  for (int id = 0; id < 5; ++id)
+    recordResume(scheduler, priorities[id], nullptr, id, order);
+  recordResume(scheduler, 0, &ticket, 5, order);
+  REQUIRE(scheduler.pending() == 6);
+  REQUIRE(scheduler.reprioritize(ticket, 5));
+  REQUIRE_THROWS(scheduler.reprioritize(ticket, 4));
+
+  release.set_value();
+  scheduler.shutdown();
+  REQUIRE(order == (std::vector<int>{5, 1, 3, 2, 0, 4}));
+  REQUIRE(scheduler.pending() == 0);
+  REQUIRE_FALSE(scheduler.reprioritize(ticket, 6));
+}
+
+/**
+ * tries to shut @scheduler down from its worker
+ */
+DetachedTask shutdownFromWorker(PriorityScheduler &scheduler,
+                                std::promise<bool> &refused) {
+  co_await scheduler.schedule(0);
+  try {
+    scheduler.shutdown();
+    refused.set_value(false);
+  } catch (std::logic_error &) {
+    refused.set_value(true);
+  }
+}
+
+TEST_CASE("Priority scheduler shutdown test") { // NOLINT
+  std::vector<int> order;
+  PriorityScheduler::Ticket ticket = 0;
+  PriorityScheduler scheduler(2);
+  std::promise<bool> refused;
+  shutdownFromWorker(scheduler, refused);
+  REQUIRE(refused.get_future().get());
+
+  // awaiting after shutdown continues inline instead of being lost
+  scheduler.shutdown();
+  recordResume(scheduler, 1, &ticket, 0, order);
+  REQUIRE(order == (std::vector<int>{0}));
+  REQUIRE(scheduler.pending() == 0);
+  REQUIRE_FALSE(scheduler.reprioritize(ticket, 2));
+}
+
+TEST_CASE("Work-stealing task pool test") { // NOLINT
+  SECTION("Priority order of one worker") {
+    std::vector<int> order;
+    std::promise<void> started, release;
+    std::shared_future<void> released = release.get_future().share();
+    WorkStealingPool pool(1);
+    pool.submit(0u, 100, [&]() {
+      started.set_value();
+      released.wait();
+    });
+    started.get_future().wait();
+    // tasks 1 and 3 have the same priority, so they keep FIFO order
+    const int priorities[] = {1, 3, 2, 3, 1};
+    for (int id = 0; id < 5; ++id)
+      pool.submit(0u, priorities[id], [&order, id]() { order.push_back(id); });
+    release.set_value();
+    pool.wait();
+    REQUIRE(order == (std::vector<int>{1, 3, 2, 0, 4}));
+  }
+
+  SECTION("Spawned tasks with and without stealing") {
+    for (bool stealing : {false, true}) {
+      std::atomic<unsigned> finished(0);
+      WorkStealingPool pool(4, stealing);
+      pool.submit(0u, 0, [&]() {
+        for (int i = 0; i < 1000; ++i)
+          pool.submit(i % 10, [&]() { finished++; });
+      });
+      pool.wait();
+      REQUIRE(finished == 1000);
+      if (!stealing)
+        REQUIRE(pool.steals() == 0);
+    }
+  }
+
+  SECTION("Exception of a task") {
+    std::atomic<unsigned> finished(0);
+    WorkStealingPool pool(2);
+    pool.submit(0, []() { throw std::runtime_error("Task failed!"); });
+    for (int i = 0; i < 10; ++i)
+      pool.submit(1, [&]() { finished++; });
+    REQUIRE_THROWS(pool.wait());
+    REQUIRE(finished == 10);
+    // the error is reported once and the pool keeps working
+    pool.submit(0, [&]() { finished++; });
+    REQUIRE_NOTHROW(pool.wait());
+    REQUIRE(finished == 11);
+  }
+}
+
+/**
+ * @return graph of @size vertices, about @fill of the pairs of vertices are
+ * connected by edges of weights 1 .. @max
+ */
+Graph randomMatrixGraph(size_t size, double fill, int max, unsigned seed) {
+  std::mt19937 generator(seed);
+  Graph graph(size);
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < size; ++j) {
+      if (i != j)
+        graph.matrix[i * size + j] =
+            generator() % 1000 < fill * 1000
+                ? static_cast<int>(generator() % max) + 1
+                : MY_MAX;
+    }
+  }
+  return graph;
+}
+
+TEST_CASE("CSR graph test") { // NOLINT
+  Graph matrix = randomMatrixGraph(100, 0.05, 30, 11);
+  CsrGraph graph = CsrGraph::fromMatrix(matrix);
+  size_t edges = 0;
+  for (int weight : matrix.matrix)
+    edges += weight != 0 && weight != MY_MAX;
+  REQUIRE(graph.size() == 100);
+  REQUIRE(graph.edgeCount() == edges);
+
+  for (unsigned from : {0u, 42u, 99u}) {
+    std::vector<unsigned> expected =
+        matrix.shortestPathFibHeap(from, false, false);
+    REQUIRE(graph.shortestPathFibHeap(from, false, false) == expected);
+    REQUIRE(graph.shortestPathPriorityQueue(from, false, false) == expected);
+  }
+
+  // distances in the reversed graph are distances to the source
+  CsrGraph reversed = graph.reversed();
+  REQUIRE(reversed.edgeCount() == graph.edgeCount());
+  std::vector<unsigned> toZero = reversed.shortestPathFibHeap(0, false, false);
+  for (unsigned v = 0; v < 100; v += 7)
+    REQUIRE(toZero[v] == matrix.shortestPathFibHeap(v, false, false)[0]);
+
+  CsrGraph fromEdges(3, {{0, 2, 5}, {1, 0, 1}, {0, 1, 2}});
+  REQUIRE(fromEdges.offsets()[1] == 2);
+  REQUIRE(fromEdges.targets()[0] == 2);
+  REQUIRE(fromEdges.weights()[1] == 2);
+  REQUIRE_THROWS(CsrGraph(2, {{0, 2, 1}}));
+  REQUIRE_THROWS(CsrGraph({0, 1}, {0}, {}));
+}
+
+TEST_CASE("Delta-stepping test") { // NOLINT
+  for (double fill : {0.01, 0.1, 0.5}) {
+    Graph matrix = randomMatrixGraph(200, fill, 50, 7);
+    CsrGraph graph = CsrGraph::fromMatrix(matrix);
+    std::vector<unsigned> expected =
+        matrix.shortestPathPriorityQueue(3, false, false);
+    REQUIRE(graph.shortestPathFibHeap(3, false, false) == expected);
+    for (unsigned threads : {1u, 3u}) {
+      ThreadPool pool(threads);
+      // buckets narrower, equal to and wider than the weights
+      for (unsigned delta : {1u, 10u, 50u, 1000u})
+        REQUIRE(graph.shortestPathDeltaStepping(3, delta, pool, false,
+                                                false) == expected);
+    }
+  }
+
+  // zero weight edges stay in the bucket of their source
+  CsrGraph zero(4, {{0, 1, 0}, {1, 2, 5}, {0, 2, 10}, {2, 3, 0}});
+  ThreadPool pool(2);
+  REQUIRE(zero.shortestPathDeltaStepping(0, 3, pool, false, false) ==
+          (std::vector<unsigned>{0, 0, 5, 5}));
+}
+
+/**
+ * @return adjacency matrix with the lightest of parallel edges of @generated
+ */
+Graph matrixFromGenerated(const GeneratedGraph &generated) {
+  const size_t size = generated.vertices;
+  Graph graph(size);
+  for (size_t i = 0; i < size * size; ++i)
+    graph.matrix[i] = i % (size + 1) ? MY_MAX : 0;
+  for (const CsrGraph::Edge &edge : generated.edges) {
+    int &weight = graph.matrix[edge.from * size + edge.to];
+    weight = std::min(weight, static_cast<int>(edge.weight));
+  }
+  return graph;
+}
+
+/**
+ * checks that @generated is undirected, without self-loops, with weights
+ * 1 .. @max, and that Dijkstra on its CSR form equals the matrix one
+ */
+void checkGenerated(const GeneratedGraph &generated, unsigned max) {
+  REQUIRE(generated.edges.size() % 2 == 0);
+  for (size_t e = 0; e < generated.edges.size(); e += 2) {
+    const CsrGraph::Edge &edge = generated.edges[e];
+    const CsrGraph::Edge &back = generated.edges[e + 1];
+    REQUIRE(edge.from < generated.vertices);
+    REQUIRE(edge.to < generated.vertices);
+    REQUIRE(edge.from != edge.to);
+    REQUIRE((edge.weight >= 1 && edge.weight <= max));
+    REQUIRE((back.from == edge.to && back.to == edge.from &&
+             back.weight == edge.weight));
+  }
+  CsrGraph graph = generated.toCsr();
+  std::vector<unsigned> expected =
+      matrixFromGenerated(generated).shortestPathPriorityQueue(0, false, false);
+  REQUIRE(graph.shortestPathFibHeap(0, false, false) == expected);
+}
+
+TEST_CASE("Graph generators test") { // NOLINT
+  SECTION("Erdos-Renyi") {
+    GeneratedGraph graph = generateErdosRenyi(200, 600, 50, 3);
+    REQUIRE(graph.vertices == 200);
+    REQUIRE(graph.edges.size() == 1200);
+    REQUIRE(graph.coordinates.empty());
+    checkGenerated(graph, 50);
+  }
+
+  SECTION("Geometric") {
+    const double scale = 1000;
+    GeneratedGraph graph = generateGeometric(300, 6, scale, 3);
+    REQUIRE(graph.coordinates.size() == 300);
+    // exactly the pairs closer than the radius are connected
+    const double radius = std::sqrt(6 / (std::acos(-1.0) * 300));
+    checkGenerated(graph, static_cast<unsigned>(std::ceil(radius * scale)));
+    size_t close = 0;
+    for (size_t u = 0; u < 300; ++u) {
+      for (size_t v = u + 1; v < 300; ++v) {
+        double dx = graph.coordinates[u].x - graph.coordinates[v].x;
+        double dy = graph.coordinates[u].y - graph.coordinates[v].y;
+        close += std::sqrt(dx * dx + dy * dy) < radius;
+      }
+    }
+    REQUIRE(graph.edges.size() == 2 * close);
+  }
+
+  SECTION("Grid") {
+    GeneratedGraph full = generateGrid(12, 9, 20, 0, 3);
+    REQUIRE(full.vertices == 108);
+    REQUIRE(full.edges.size() == 2 * (11 * 9 + 12 * 8));
+    REQUIRE(full.coordinates[13].x == 1);
+    REQUIRE(full.coordinates[13].y == 1);
+    checkGenerated(full, 20);
+    GeneratedGraph dropped = generateGrid(12, 9, 20, 0.3f, 3);
+    REQUIRE(dropped.edges.size() < full.edges.size());
+    checkGenerated(dropped, 20);
+  }
+
+  SECTION("R-MAT") {
+    GeneratedGraph graph = generateRMat(8, 1000, 50, 3);
+    REQUIRE(graph.vertices == 256);
+    REQUIRE(graph.edges.size() == 2000);
+    checkGenerated(graph, 50);
+  }
+
+  SECTION("Same seed, same graph") {
+    GeneratedGraph first = generateRMat(6, 100, 50, 9);
+    GeneratedGraph second = generateRMat(6, 100, 50, 9);
+    REQUIRE(first.edges.size() == second.edges.size());
+    for (size_t e = 0; e < first.edges.size(); ++e) {
+      REQUIRE(first.edges[e].from == second.edges[e].from);
+      REQUIRE(first.edges[e].to == second.edges[e].to);
+      REQUIRE(first.edges[e].weight == second.edges[e].weight);
+    }
+  }
+
+  SECTION("Invalid arguments") {
+    REQUIRE_THROWS(generateErdosRenyi(1, 10, 50, 3));
+    REQUIRE_THROWS(generateErdosRenyi(0, 0, 50, 3));
+    REQUIRE_THROWS(generateErdosRenyi(10, 10, 0, 3));
+    REQUIRE_THROWS(generateGeometric(10, 0, 1000, 3));
+    REQUIRE_THROWS(generateGrid(4, 4, 0, 0, 3));
+    REQUIRE_THROWS(generateRMat(0, 10, 50, 3));
+    REQUIRE_THROWS(generateRMat(32, 10, 50, 3));
+    REQUIRE_THROWS(generateRMat(64, 10, 50, 3));
+    REQUIRE_THROWS(generateRMat(4, 10, 0, 3));
+    REQUIRE(generateErdosRenyi(2, 3, 1, 3).edges.size() == 6);
+    REQUIRE(generateRMat(1, 3, 1, 3).vertices == 2);
+  }
+}
+
+/**
+ * @return path of a file @name in the temporary directory
+ */
+std::string temporaryPath(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/**
+ * @return true if both graphs have the same edges in the same order
+ */
+bool sameGraph(const CsrGraph &first, const CsrGraph &second) {
+  if (first.size() != second.size() ||
+      first.edgeCount() != second.edgeCount())
+    return false;
+  return std::equal(first.offsets(), first.offsets() + first.size() + 1,
+                    second.offsets()) &&
+         std::equal(first.targets(), first.targets() + first.edgeCount(),
+                    second.targets()) &&
+         std::equal(first.weights(), first.weights() + first.edgeCount(),
+                    second.weights());
+}
+
+TEST_CASE("Graph loader test") { // NOLINT
+  const std::string path = temporaryPath("fibheap_loader_test.txt");
+  auto write = [&](const std::string &text) {
+    std::ofstream file(path);
+    file << text;
+  };
+
+  SECTION("DIMACS round trip") {
+    CsrGraph graph = generateRMat(9, 3000, 1000, 5).toCsr();
+    saveDimacs(path, graph);
+    for (unsigned threads : {1u, 3u, 8u}) {
+      CsrGraph loaded = loadDimacs(path, threads);
+      REQUIRE(sameGraph(loaded, graph));
+      REQUIRE(loaded.shortestPathFibHeap(0, false, false) ==
+              graph.shortestPathPriorityQueue(0, false, false));
+    }
+  }
+
+  SECTION("Edge list") {
+    write("# comment\n0 1 5\n% comment\n\n1 2\n  2 0 7\n");
+    for (unsigned threads : {1u, 2u}) {
+      CsrGraph loaded = loadEdgeList(path, threads);
+      REQUIRE(sameGraph(loaded, CsrGraph(3, {{0, 1, 5}, {1, 2, 1}, {2, 0, 7}})));
+    }
+  }
+
+  SECTION("Malformed files") {
+    write("p sp 2 1\na 1 x 3\n");
+    REQUIRE_THROWS(loadDimacs(path, 1));
+    write("a 1 2 3\n");
+    REQUIRE_THROWS(loadDimacs(path, 1));
+    write("p sp 2 1\na 1 3 3\n");
+    REQUIRE_THROWS(loadDimacs(path, 1));
+    write("p sp 2 1\na 1 2 1000000000\n");
+    REQUIRE_THROWS(loadDimacs(path, 1));
+    write("p sp 2 1\na 1 2 99999999999999999999999\n");
+    REQUIRE_THROWS(loadDimacs(path, 1));
+    write("0 1 1000000000\n");
+    REQUIRE_THROWS(loadEdgeList(path, 1));
+    write("0 4294967295\n");
+    REQUIRE_THROWS(loadEdgeList(path, 1));
+    write("x 1\n");
+    REQUIRE_THROWS(loadEdgeList(path, 1));
+    write("0 1 999999999\n");
+    REQUIRE(loadEdgeList(path, 1).weights()[0] == 999999999);
+    // an absurd arc count does not make the loader reserve memory for it
+    write("p sp 2 18446744073709551615\na 1 2 3\n");
+    REQUIRE(sameGraph(loadDimacs(path, 1), CsrGraph(2, {{0, 1, 3}})));
+  }
+  std::filesystem::remove(path);
+  REQUIRE_THROWS(loadDimacs(path, 1));
+}
+
+TEST_CASE("Graph snapshot test") { // NOLINT
+  const std::string path = temporaryPath("fibheap_snapshot_test.csr");
+  CsrGraph graph = generateGrid(30, 20, 50, 0.1f, 5).toCsr();
+  saveSnapshot(path, graph);
+
+  SECTION("Round trip") {
+    CsrGraph mapped = loadSnapshot(path);
+    REQUIRE(sameGraph(mapped, graph));
+    REQUIRE(reinterpret_cast<std::uintptr_t>(mapped.targets()) % // NOLINT
+                SNAPSHOT_ALIGNMENT ==
+            0);
+    REQUIRE(mapped.shortestPathFibHeap(7, false, false) ==
+            graph.shortestPathPriorityQueue(7, false, false));
+    // copies share the mapping, which outlives the original graph
+    CsrGraph copy = mapped;
+    mapped = CsrGraph();
+    REQUIRE(sameGraph(copy, graph));
+
+    CsrGraph empty;
+    saveSnapshot(path, empty);
+    REQUIRE(sameGraph(loadSnapshot(path), empty));
+  }
+
+  SECTION("DIMACS conversion") {
+    const std::string dimacs = temporaryPath("fibheap_snapshot_test.gr");
+    saveDimacs(dimacs, graph);
+    convertDimacsToSnapshot(dimacs, path, 2);
+    REQUIRE(sameGraph(loadSnapshot(path), graph));
+    std::filesystem::remove(dimacs);
+  }
+
+  SECTION("Invalid snapshots") {
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    REQUIRE_THROWS(loadSnapshot(path));
+    {
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      file.write("NOTACSR", 7);
+    }
+    REQUIRE_THROWS(loadSnapshot(path));
+    std::filesystem::resize_file(path, 8);
+    REQUIRE_THROWS(loadSnapshot(path));
+  }
+
+  SECTION("Corrupted header") {
+    // sizes that overflow the bounds checks must not reach the arrays
+    auto corrupt = [&](auto change) {
+      saveSnapshot(path, graph);
+      SnapshotHeader header;
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      file.read(reinterpret_cast<char *>(&header), sizeof(header));
+      change(header);
+      file.seekp(0);
+      file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    };
+    const uint64_t highest = std::numeric_limits<uint64_t>::max();
+    corrupt([](SnapshotHeader &header) { header.vertices = highest; });
+    REQUIRE_THROWS(loadSnapshot(path));
+    corrupt([](SnapshotHeader &header) { header.vertices = highest / 8 + 1; });
+    REQUIRE_THROWS(loadSnapshot(path));
+    corrupt([](SnapshotHeader &header) { header.edges = highest / 4 + 1; });
+    REQUIRE_THROWS(loadSnapshot(path));
+    corrupt([&](SnapshotHeader &header) {
+      header.targetsPosition = highest / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+    });
+    REQUIRE_THROWS(loadSnapshot(path));
+    corrupt([&](SnapshotHeader &header) {
+      header.offsetsPosition = header.fileSize;
+      header.vertices = 0;
+    });
+    REQUIRE_THROWS(loadSnapshot(path));
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Zero weight edges test") { // NOLINT
+  // the zero weight edge makes vertex 1 as close as the top being settled
+  CsrGraph graph(4, {{0, 1, 0}, {1, 2, 5}, {0, 2, 10}, {2, 3, 0}});
+  const std::vector<unsigned> expected = {0, 0, 5, 5};
+  REQUIRE(graph.shortestPathFibHeap(0, false, false) == expected);
+  REQUIRE(graph.shortestPathPriorityQueue(0, false, false) == expected);
+  Graph matrix = randomMatrixGraph(4, 0, 1, 0);
+  for (const CsrGraph::Edge &edge : {CsrGraph::Edge{0, 1, 0},
+                                     CsrGraph::Edge{1, 2, 5},
+                                     CsrGraph::Edge{0, 2, 10},
+                                     CsrGraph::Edge{2, 3, 0}})
+    matrix.matrix[edge.from * 4 + edge.to] = static_cast<int>(edge.weight);
+  REQUIRE(matrix.shortestPathFibHeap(0, false, false) == expected);
+}
+
+TEST_CASE("Bidirectional Dijkstra test") { // NOLINT
+  // sparse directed graphs leave some pairs unreachable
+  for (double fill : {0.01, 0.05}) {
+    CsrGraph graph =
+        CsrGraph::fromMatrix(randomMatrixGraph(150, fill, 40, 13));
+    CsrGraph reversed = graph.reversed();
+    for (unsigned from : {0u, 37u, 149u}) {
+      std::vector<unsigned> expected =
+          graph.shortestPathFibHeap(from, false, false);
+      for (unsigned to = 0; to < 150; to += 3) {
+        PathQueryResult result =
+            shortestPathBidirectional(graph, reversed, from, to);
+        REQUIRE(result.distance == expected[to]);
+      }
+      REQUIRE(shortestPathBidirectional(graph, reversed, from, from)
+                  .distance == 0);
+    }
+  }
+
+  CsrGraph isolated(3, {{0, 1, 4}});
+  REQUIRE(shortestPathBidirectional(isolated, isolated.reversed(), 0, 2)
+              .distance == MY_MAX);
+  REQUIRE(shortestPathBidirectional(isolated, isolated.reversed(), 1, 0)
+              .distance == MY_MAX);
+}
+
+/**
+ * checks that A* with all heuristics finds the distances of Dijkstra
+ */
+void checkAStar(const GeneratedGraph &generated, bool grid, double scale) {
+  CsrGraph graph = generated.toCsr();
+  CsrGraph reversed = graph.reversed();
+  Landmarks landmarks(graph, reversed, 4);
+  for (unsigned from : {0u, 77u}) {
+    std::vector<unsigned> expected =
+        graph.shortestPathFibHeap(from, false, false);
+    for (unsigned to = 0; to < graph.size(); to += 11) {
+      REQUIRE(shortestPathAStar(graph, from, to, ZeroHeuristic()).distance ==
+              expected[to]);
+      REQUIRE(shortestPathAStar(graph, from, to,
+                                LandmarkHeuristic(landmarks, to))
+                  .distance == expected[to]);
+      PathQueryResult geometric =
+          grid ? shortestPathAStar(
+                     graph, from, to,
+                     ManhattanHeuristic(generated.coordinates, to, scale))
+               : shortestPathAStar(
+                     graph, from, to,
+                     EuclideanHeuristic(generated.coordinates, to, scale));
+      REQUIRE(geometric.distance == expected[to]);
+    }
+  }
+}
+
+TEST_CASE("A* search test") { // NOLINT
+  SECTION("Geometric graph") {
+    checkAStar(generateGeometric(300, 6, 1000, 17), false, 1000);
+    // sparse graph, some targets are unreachable
+    checkAStar(generateGeometric(300, 1.5, 1000, 18), false, 1000);
+  }
+  SECTION("Grid graph") {
+    checkAStar(generateGrid(20, 15, 9, 0, 19), true, 1);
+    checkAStar(generateGrid(20, 15, 9, 0.4f, 20), true, 1);
+  }
+}
+
+/**
+ * checks that settled vertices of @result have exact distances in order,
+ * the other vertices are not farther than the last settled one
+ * @return distance of the last settled vertex
+ */
+unsigned checkBounded(const DijkstraResult &result,
+                      const std::vector<unsigned> &expected) {
+  unsigned last = 0;
+  for (unsigned v : result.settled) {
+    REQUIRE(result.distances[v] == expected[v]);
+    REQUIRE(result.distances[v] >= last);
+    last = result.distances[v];
+  }
+  size_t settled = 0;
+  for (unsigned v = 0; v < expected.size(); ++v) {
+    if (result.distances[v] != MY_MAX)
+      settled++;
+    else
+      REQUIRE(expected[v] >= last);
+  }
+  REQUIRE(settled == result.settled.size());
+  return last;
+}
+
+TEST_CASE("Dijkstra early termination test") { // NOLINT
+  CsrGraph graph = generateGeometric(400, 6, 1000, 23).toCsr();
+  const unsigned from = 5;
+  std::vector<unsigned> expected =
+      graph.shortestPathFibHeap(from, false, false);
+
+  DijkstraResult full = shortestPathBounded(graph, from, DijkstraOptions());
+  REQUIRE(full.distances == expected);
+  REQUIRE(full.complete);
+  REQUIRE(full.settled.size() > 300);
+
+  SECTION("Targets") {
+    // reachable targets in the order of their distance
+    const unsigned near = full.settled[100], middle = full.settled[200],
+                   far = full.settled[300];
+    DijkstraOptions options;
+    options.targets = {middle, far, near};
+    DijkstraResult result = shortestPathBounded(graph, from, options);
+    unsigned last = checkBounded(result, expected);
+    unsigned farthest = 0;
+    for (unsigned target : options.targets) {
+      REQUIRE(result.distances[target] == expected[target]);
+      farthest = std::max(farthest, expected[target]);
+    }
+    REQUIRE(last == farthest);
+
+    // only the nearest target is needed
+    options.targetCount = 1;
+    result = shortestPathBounded(graph, from, options);
+    last = checkBounded(result, expected);
+    REQUIRE(last == expected[near]);
+    REQUIRE(!result.complete);
+  }
+
+  SECTION("Settled vertices") {
+    DijkstraOptions options;
+    options.maxSettled = 25;
+    DijkstraResult result = shortestPathBounded(graph, from, options);
+    checkBounded(result, expected);
+    REQUIRE(result.settled.size() == 25);
+    REQUIRE(result.settled.front() == from);
+    REQUIRE(!result.complete);
+  }
+
+  SECTION("Distance") {
+    DijkstraOptions options;
+    options.maxDistance = 150;
+    DijkstraResult result = shortestPathBounded(graph, from, options);
+    checkBounded(result, expected);
+    for (unsigned v = 0; v < graph.size(); ++v)
+      REQUIRE((result.distances[v] != MY_MAX) == (expected[v] <= 150));
+    REQUIRE(!result.complete);
+  }
+}
+
+TEST_CASE("Dijkstra workspace test") { // NOLINT
+  CsrGraph large = generateGeometric(400, 6, 1000, 29).toCsr();
+  CsrGraph small = CsrGraph::fromMatrix(randomMatrixGraph(60, 0.05, 20, 31));
+  DijkstraWorkspace workspace;
+
+  // queries on graphs of different sizes alternate on one workspace
+  for (unsigned round = 0; round < 3; ++round) {
+    for (const CsrGraph *graph : {&large, &small}) {
+      for (unsigned from = round; from < graph->size(); from += 23) {
+        std::vector<unsigned> expected =
+            graph->shortestPathFibHeap(from, false, false);
+        workspace.run(*graph, from);
+        REQUIRE(workspace.complete());
+        for (unsigned v = 0; v < graph->size(); ++v) {
+          REQUIRE(workspace.distance(v) == expected[v]);
+          REQUIRE(workspace.isSettled(v) == (expected[v] != MY_MAX));
+        }
+
+        DijkstraOptions options;
+        options.maxSettled = 10;
+        DijkstraResult bounded = shortestPathBounded(*graph, from, options);
+        workspace.run(*graph, from, options);
+        REQUIRE(workspace.settled() == bounded.settled);
+        REQUIRE(workspace.complete() == bounded.complete);
+        for (unsigned v = 0; v < graph->size(); ++v)
+          REQUIRE(workspace.distance(v) == bounded.distances[v]);
+      }
+    }
+  }
+
+  REQUIRE_THROWS(workspace.run(small, 60));
+  // the failed query does not break the next one
+  workspace.run(small, 0);
+  REQUIRE(workspace.distance(0) == 0);
+}
+
+TEST_CASE("Multi-source Dijkstra and distance table test") { // NOLINT
+  CsrGraph graph = CsrGraph::fromMatrix(randomMatrixGraph(200, 0.02, 40, 37));
+  std::vector<std::vector<unsigned>> single(graph.size());
+  for (unsigned v = 0; v < graph.size(); ++v)
+    single[v] = graph.shortestPathFibHeap(v, false, false);
+
+  SECTION("Multiple sources") {
+    DijkstraWorkspace workspace;
+    for (const std::vector<unsigned> &sources :
+         {std::vector<unsigned>{3}, std::vector<unsigned>{0, 50, 199},
+          std::vector<unsigned>{7, 7, 120, 64, 180}}) {
+      workspace.run(graph, sources);
+      for (unsigned v = 0; v < graph.size(); ++v) {
+        unsigned nearest = MY_MAX;
+        for (unsigned source : sources)
+          nearest = std::min(nearest, single[source][v]);
+        REQUIRE(workspace.distance(v) == nearest);
+        if (nearest != MY_MAX)
+          REQUIRE(single[workspace.source(v)][v] == nearest);
+      }
+    }
+    REQUIRE_THROWS(workspace.run(graph, std::vector<unsigned>{0, 200}));
+  }
+
+  SECTION("Distance table") {
+    std::vector<unsigned> sources, targets;
+    for (unsigned v = 0; v < graph.size(); v += 9)
+      sources.push_back(v);
+    for (unsigned v = 4; v < graph.size(); v += 13)
+      targets.push_back(v);
+    for (unsigned threads : {1u, 4u}) {
+      ThreadPool pool(threads);
+      std::vector<std::vector<unsigned>> table =
+          distanceTable(graph, sources, targets, pool);
+      REQUIRE(table.size() == sources.size());
+      for (size_t i = 0; i < sources.size(); ++i) {
+        REQUIRE(table[i].size() == targets.size());
+        for (size_t j = 0; j < targets.size(); ++j)
+          REQUIRE(table[i][j] == single[sources[i]][targets[j]]);
+      }
+    }
+  }
+}
+
+/**
+ * @return random symmetric graph with every undirected edge present with
+ * probability @fill (with a parallel edge with probability @fill / 4,
+ * self-loops included)
+ */
+CsrGraph randomSymmetricGraph(unsigned vertices, double fill, unsigned max,
+                              unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> coin(0, 1);
+  GeneratedGraph graph;
+  graph.vertices = vertices;
+  for (unsigned u = 0; u < vertices; ++u) {
+    for (unsigned v = u; v < vertices; ++v) {
+      if (coin(generator) < fill)
+        addUndirectedEdge(graph, u, v, generator() % max + 1);
+      if (coin(generator) < fill / 4)
+        addUndirectedEdge(graph, u, v, generator() % max + 1);
+    }
+  }
+  return graph.toCsr();
+}
+
+/**
+ * Kruskal's algorithm
+ * @return weight and number of components of the minimum spanning forest
+ */
+std::pair<unsigned long long, size_t> kruskal(const CsrGraph &graph) {
+  std::vector<CsrGraph::Edge> edges;
+  for (unsigned u = 0; u < graph.size(); ++u) {
+    for (uint64_t e = graph.offsets()[u]; e < graph.offsets()[u + 1]; ++e)
+      edges.push_back(CsrGraph::Edge{u, graph.targets()[e], graph.weights()[e]});
+  }
+  std::sort(edges.begin(), edges.end(),
+            [](const CsrGraph::Edge &first, const CsrGraph::Edge &second) {
+              return first.weight < second.weight;
+            });
+  std::vector<unsigned> component(graph.size());
+  for (unsigned v = 0; v < graph.size(); ++v)
+    component[v] = v;
+  auto find = [&](unsigned v) {
+    while (component[v] != v)
+      v = component[v] = component[component[v]];
+    return v;
+  };
+  unsigned long long weight = 0;
+  size_t components = graph.size();
+  for (const CsrGraph::Edge &edge : edges) {
+    unsigned from = find(edge.from), to = find(edge.to);
+    if (from != to) {
+      component[from] = to;
+      weight += edge.weight;
+      components--;
+    }
+  }
+  return {weight, components};
+}
+
+/**
+ * @return total weight of edges leaving the vertices with @inside set
+ */
+unsigned long long cutWeight(const CsrGraph &graph,
+                             const std::vector<bool> &inside) {
+  unsigned long long weight = 0;
+  for (unsigned u = 0; u < graph.size(); ++u) {
+    for (uint64_t e = graph.offsets()[u]; e < graph.offsets()[u + 1]; ++e) {
+      if (inside[u] && !inside[graph.targets()[e]])
+        weight += graph.weights()[e];
+    }
+  }
+  return weight;
+}
+
+/**
+ * checks Prim's algorithm with @engine against Kruskal's algorithm
+ */
+template <typename Engine>
+void checkSpanningTree(const CsrGraph &graph, Engine &engine) {
+  SpanningTree tree = minimumSpanningTree(graph, engine);
+  std::pair<unsigned long long, size_t> expected = kruskal(graph);
+  REQUIRE(tree.weight == expected.first);
+  REQUIRE(tree.components == expected.second);
+  REQUIRE(tree.parent.size() == graph.size());
+
+  // parents form the forest: the lightest edge to every parent sums up
+  unsigned long long weight = 0;
+  size_t roots = 0;
+  for (unsigned v = 0; v < graph.size(); ++v) {
+    if (tree.parent[v] == MY_MAX) {
+      roots++;
+      continue;
+    }
+    unsigned lightest = MY_MAX;
+    for (uint64_t e = graph.offsets()[v]; e < graph.offsets()[v + 1]; ++e) {
+      if (graph.targets()[e] == tree.parent[v])
+        lightest = std::min(lightest, graph.weights()[e]);
+    }
+    REQUIRE(lightest != MY_MAX);
+    weight += lightest;
+  }
+  REQUIRE(roots == tree.components);
+  REQUIRE(weight == tree.weight);
+}
+
+/**
+ * checks Stoer-Wagner algorithm with @engine against all cuts of the graph
+ */
+template <typename Engine>
+void checkMinimumCut(const CsrGraph &graph, Engine &engine) {
+  const unsigned size = static_cast<unsigned>(graph.size());
+  if (size < 2) {
+    REQUIRE_THROWS(minimumCut(graph, engine));
+    return;
+  }
+  // vertex 0 stays outside, so every cut is enumerated once
+  unsigned long long expected = static_cast<unsigned long long>(-1);
+  for (unsigned mask = 1; mask < (1u << (size - 1)); ++mask) {
+    std::vector<bool> inside(size, false);
+    for (unsigned v = 1; v < size; ++v)
+      inside[v] = mask >> (v - 1) & 1;
+    expected = std::min(expected, cutWeight(graph, inside));
+  }
+
+  MinimumCut cut = minimumCut(graph, engine);
+  REQUIRE(cut.weight == expected);
+  REQUIRE_FALSE(cut.side.empty());
+  REQUIRE(cut.side.size() < size);
+  std::vector<bool> inside(size, false);
+  for (unsigned v : cut.side)
+    inside[v] = true;
+  REQUIRE(cutWeight(graph, inside) == cut.weight);
+}
+
+TEST_CASE("Minimum spanning tree and minimum cut test") { // NOLINT
+  FibHeapEngine<unsigned> treeFib;
+  LazyQueueEngine<unsigned> treeLazy;
+  FibHeapEngine<long long> cutFib;
+  LazyQueueEngine<long long> cutLazy;
+  unsigned seed = 0;
+  // sparse graphs are mostly disconnected, n <= 2 covers the trivial cases
+  for (unsigned vertices = 0; vertices <= 9; ++vertices) {
+    for (double fill : {0.05, 0.2, 0.5, 1.0}) {
+      for (int repeat = 0; repeat < 5; ++repeat) {
+        CsrGraph graph = randomSymmetricGraph(vertices, fill, 20, ++seed);
+        checkSpanningTree(graph, treeFib);
+        checkSpanningTree(graph, treeLazy);
+        checkMinimumCut(graph, cutFib);
+        checkMinimumCut(graph, cutLazy);
+      }
+    }
+  }
+  REQUIRE(minimumSpanningTree(CsrGraph()).components == 0);
+  REQUIRE(minimumCut(CsrGraph(2, {{0, 1, 7}, {1, 0, 7}})).weight == 7);
+}
+
+TEST_CASE("Latency histogram test") { // NOLINT
+  using Histogram = LatencyHistogram;
+  const size_t exact = size_t(1) << Histogram::SubBits;
+  const size_t last = Histogram::bucketCount() - 1;
+
+  SECTION("Buckets") {
+    for (size_t value = 0; value < exact; ++value) {
+      REQUIRE(Histogram::index(value) == value);
+      REQUIRE(Histogram::highestValue(value) == value);
+    }
+    // buckets are contiguous, every one starts right after the previous one
+    for (size_t i = 0; i < last; ++i) {
+      REQUIRE(Histogram::index(Histogram::highestValue(i)) == i);
+      REQUIRE(Histogram::index(Histogram::highestValue(i) + 1) == i + 1);
+    }
+    for (unsigned bit = Histogram::SubBits; bit < 64; ++bit) {
+      uint64_t power = uint64_t(1) << bit;
+      REQUIRE(Histogram::index(power) == Histogram::index(power - 1) + 1);
+      REQUIRE(Histogram::highestValue(Histogram::index(power) - 1) ==
+              power - 1);
+    }
+    // the top bucket ends exactly at the highest value
+    REQUIRE(Histogram::index(UINT64_MAX) == last);
+    REQUIRE(Histogram::highestValue(last) == UINT64_MAX);
+  }
+
+  SECTION("Relative error") {
+    std::mt19937_64 generator(7);
+    for (int i = 0; i < 100000; ++i) {
+      uint64_t value = generator() >> (generator() % 64);
+      uint64_t highest = Histogram::highestValue(Histogram::index(value));
+      REQUIRE(highest >= value);
+      // the bucket is narrower than 2^(1 - SubBits) of its values
+      REQUIRE(highest - value <= value >> (Histogram::SubBits - 1));
+    }
+  }
+
+  SECTION("Percentiles") {
+    Histogram histogram;
+    REQUIRE(histogram.percentile(50) == 0);
+    REQUIRE(histogram.min() == 0);
+    for (uint64_t value = 100; value >= 1; --value)
+      histogram.record(value);
+    REQUIRE(histogram.count() == 100);
+    REQUIRE(histogram.min() == 1);
+    REQUIRE(histogram.max() == 100);
+    REQUIRE(histogram.mean() == Approx(50.5));
+    REQUIRE(histogram.percentile(0) == 1);
+    REQUIRE(histogram.percentile(50) == 50);
+    REQUIRE(histogram.percentile(99) == 99);
+    REQUIRE(histogram.percentile(100) == 100);
+
+    // large values report the end of their bucket, but at most max
+    Histogram large;
+    large.record(1000);
+    large.record(2000);
+    REQUIRE(large.percentile(50) ==
+            Histogram::highestValue(Histogram::index(1000)));
+    REQUIRE(large.percentile(50) > 1000);
+    REQUIRE(large.percentile(100) == 2000);
+    large.record(UINT64_MAX);
+    REQUIRE(large.percentile(100) == UINT64_MAX);
+    REQUIRE(large.max() == UINT64_MAX);
+
+    histogram.merge(large);
+    REQUIRE(histogram.count() == 103);
+    REQUIRE(histogram.min() == 1);
+    REQUIRE(histogram.percentile(100) == UINT64_MAX);
+    REQUIRE(histogram.percentile(50) == 52);
+    histogram.clear();
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.percentile(100) == 0);
+  }
+}
+
+/**
+ * replays @workload on an ordered set (ties broken by lower id)
+ * @return checksum computed the same way as runWorkload
+ */
+unsigned long long referenceChecksum(const Workload &workload) {
+  std::set<std::pair<unsigned long long, unsigned>> heap;
+  std::vector<unsigned long long> current(workload.keys);
+  unsigned long long checksum = 0;
+  for (const WorkloadOperation &operation : workload.operations) {
+    switch (operation.type) {
+    case WorkloadOperation::Push:
+      current[operation.id] = operation.key;
+      heap.emplace(operation.key, operation.id);
+      break;
+    case WorkloadOperation::Decrease:
+      heap.erase(std::make_pair(current[operation.id], operation.id));
+      current[operation.id] = operation.key;
+      heap.emplace(operation.key, operation.id);
+      break;
+    case WorkloadOperation::Pop:
+      checksum = checksum * 1000003 + heap.begin()->second;
+      heap.erase(heap.begin());
+      break;
+    case WorkloadOperation::Erase:
+      heap.erase(std::make_pair(current[operation.id], operation.id));
+      break;
+    case WorkloadOperation::Merge:
+      for (unsigned id = operation.id; id < operation.id + operation.count;
+           ++id)
+        heap.emplace(current[id], id);
+      break;
+    }
+  }
+  return checksum;
+}
+
+TEST_CASE("Workload test") { // NOLINT
+  FibHeapEngine<unsigned long long> fib;
+  LazyQueueEngine<unsigned long long> lazy;
+  for (const char *mix : {"hold", "sorting", "decrease", "delete", "merge"}) {
+    for (const char *distribution :
+         {"uniform", "exponential", "sorted", "reverse", "duplicates"}) {
+      Workload workload = generateWorkload(mix, distribution, 300, 3000, 11);
+      REQUIRE(workload.operations.size() >= 3000);
+      unsigned long long expected = referenceChecksum(workload);
+      REQUIRE(expected != 0);
+      REQUIRE(runWorkload(fib, workload) == expected);
+      REQUIRE(runWorkload(lazy, workload) == expected);
+      // the engines are reused, so reset has to forget the previous run
+      REQUIRE(runWorkload(fib, workload) == expected);
+    }
+  }
+  REQUIRE_THROWS(generateWorkload("unknown", "uniform", 10, 10, 1));
+  REQUIRE_THROWS(generateWorkload("hold", "unknown", 10, 10, 1));
+  REQUIRE_THROWS(KeyDistribution("normal", 1));
+}
+
+TEST_CASE("Trace round trip test") { // NOLINT
+  // values 0 .. 9 repeat many times, so most pops choose among equal values
+  TracingFibHeap<int> heap(
+      [](const int &value) { return 1000ULL - static_cast<unsigned>(value); });
+  std::mt19937 generator(5);
+  std::vector<unsigned> live;
+  unsigned long long checksum = 0;
+  auto pop = [&] {
+    unsigned id = heap.top_id();
+    checksum = checksum * 1000003 + id;
+    heap.extract_top();
+    live.erase(std::find(live.begin(), live.end(), id));
+  };
+
+  for (int round = 0; round < 200; ++round) {
+    unsigned roll = generator() % 10;
+    if (live.empty() || roll < 4) {
+      live.push_back(heap.insert(static_cast<int>(generator() % 10)));
+    } else if (roll < 6) {
+      pop();
+    } else if (roll < 7) {
+      unsigned id = live[generator() % live.size()];
+      heap.delete_value(id);
+      live.erase(std::find(live.begin(), live.end(), id));
+    } else if (roll < 8) {
+      // 10 + round is above all values so far, the key strictly decreases
+      unsigned id = live[generator() % live.size()];
+      heap.increase_key(id, 10 + round);
+    } else {
+      std::vector<int> values(generator() % 5 + 1);
+      for (int &value : values)
+        value = static_cast<int>(generator() % 10);
+      unsigned first = heap.merge(values);
+      for (unsigned id = first; id < first + values.size(); ++id)
+        live.push_back(id);
+    }
+  }
+  while (!heap.empty())
+    pop();
+
+  const std::string path = temporaryPath("fibheap_trace_test.bin");
+  saveTrace(path, heap.trace());
+  Workload loaded = loadTrace(path);
+  std::filesystem::remove(path);
+  REQUIRE(loaded.keys == heap.trace().keys);
+  REQUIRE(loaded.operations.size() == heap.trace().operations.size());
+  REQUIRE(referenceChecksum(loaded) == checksum);
+  FibHeapEngine<unsigned long long> fib;
+  LazyQueueEngine<unsigned long long> lazy;
+  REQUIRE(runWorkload(fib, loaded) == checksum);
+  REQUIRE(runWorkload(lazy, loaded) == checksum);
+}
@@ -0,0 +1,6 @@
+/**
+ * Catch main of the unit tests (test.cpp), compiled once for all test
+ * targets
+ */
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"